@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ansipp.hpp>
+
+#include "pty_harness.hpp"
+#include "scene.hpp"
+#include "ncurses_scene.hpp"
+
+using namespace ansipp;
+
+namespace {
+
+constexpr unsigned short cols = 160;
+constexpr unsigned short rows = 50;
+constexpr unsigned int percents[] = { 1, 5, 10, 25, 50, 100 };
+
+// scene cell colors in ANSI order map directly to ansipp colors
+class ansipp_screen {
+    charbuf out = charbuf(64 * 1024);
+public:
+    void open() {
+        out << alternate_buffer.on() << cursor_visibility.off() << attrs().bg(BLACK) << erase(SCREEN, ALL);
+        flush();
+    }
+
+    void frame(const std::vector<scene_cell>& cells) {
+        int cx = -1, cy = -1, color = -1;
+        for (const scene_cell& c: cells) {
+            if (c.x != cx || c.y != cy) out << move_abs(c.x + 1, c.y + 1);
+            if (c.color != color) out << attrs().fg(static_cast<ansipp::color>(c.color)).bg(BLACK);
+            out << c.ch;
+            cx = c.x + 1;
+            cy = c.y;
+            color = c.color;
+        }
+        flush();
+    }
+
+    void close() {
+        out << attrs() << cursor_visibility.on() << alternate_buffer.off();
+        flush();
+    }
+
+    void flush() {
+        for (std::string_view data = out.flush(); !data.empty();) {
+            const std::streamsize w = stdout_write(data);
+            if (w < 0) break;
+            data.remove_prefix(static_cast<std::size_t>(w));
+        }
+    }
+};
+
+struct screen_api {
+    std::string name;
+    std::function<void()> open;
+    std::function<void(const std::vector<scene_cell>&)> frame;
+    std::function<void()> close;
+};
+
+struct samples {
+    std::vector<double> values;
+
+    double mean() const {
+        double sum = 0;
+        for (double v: values) sum += v;
+        return values.empty() ? 0 : sum / static_cast<double>(values.size());
+    }
+
+    double stddev() const {
+        const double m = mean();
+        double sum = 0;
+        for (double v: values) sum += (v - m) * (v - m);
+        return values.empty() ? 0 : std::sqrt(sum / static_cast<double>(values.size()));
+    }
+};
+
+struct measurement {
+    samples cpu_ns;
+    samples bytes;
+    samples latency_ns;
+};
+
+double thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+measurement measure(pty_harness& pty, const screen_api& api, unsigned int percent, unsigned int frames) {
+    std::vector<std::vector<scene_cell>> script(frames);
+    for (unsigned int i = 0; i < frames; ++i) scene_frame(i, percent, cols, rows, script[i]);
+
+    measurement m;
+    api.open();
+    pty.settle();
+    for (const std::vector<scene_cell>& cells: script) {
+        // settled output for latency of this frame only, cpu time excludes waiting
+        const std::uint64_t drained = pty.drained_bytes();
+        const double cpu = thread_cpu_ns();
+        const std::int64_t start = pty.mark();
+        api.frame(cells);
+        m.cpu_ns.values.push_back(thread_cpu_ns() - cpu);
+        // frame may produce no output at all (i.e. ncurses found nothing to update)
+        if (const std::int64_t latency = pty.wait_first_byte(start); latency >= 0) m.latency_ns.values.push_back(static_cast<double>(latency));
+        pty.settle();
+        m.bytes.values.push_back(static_cast<double>(pty.drained_bytes() - drained));
+    }
+    api.close();
+    pty.settle();
+    return m;
+}
+
+struct metric {
+    std::string_view test_case;
+    std::string_view ylabel;
+    samples measurement::* field;
+};
+
+constexpr metric metrics[] = {
+    { "ncurses: cpu time", "nanos", &measurement::cpu_ns },
+    { "ncurses: output bytes", "bytes", &measurement::bytes },
+    { "ncurses: first byte latency", "nanos", &measurement::latency_ns }
+};
+
+// same structure as Catch2 XML reporter output, so `benchmark.py` can plot it
+void write_xml(std::FILE* f, std::string_view filter, const std::vector<screen_api>& apis, const std::vector<std::vector<measurement>>& results) {
+    std::fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Catch2TestRun name=\"ansipp_bench_ncurses\">\n");
+    for (const metric& mt: metrics) {
+        if (!filter.empty() && filter != mt.test_case) continue;
+        std::fprintf(f, "  <TestCase name=\"%.*s\">\n", static_cast<int>(mt.test_case.size()), mt.test_case.data());
+        for (std::size_t p = 0; p < std::size(percents); ++p) {
+            std::fprintf(f, "    <Section name=\"xlabel=%% of changed cells;ylabel=%.*s;x=%u\">\n",
+                static_cast<int>(mt.ylabel.size()), mt.ylabel.data(), percents[p]);
+            for (std::size_t a = 0; a < apis.size(); ++a) {
+                const samples& s = results[a][p].*mt.field;
+                const auto [lo, hi] = std::minmax_element(s.values.begin(), s.values.end());
+                std::fprintf(f, "      <BenchmarkResults name=\"%s\" samples=\"%zu\">\n", apis[a].name.c_str(), s.values.size());
+                std::fprintf(f, "        <mean value=\"%.1f\" lowerBound=\"%.1f\" upperBound=\"%.1f\"/>\n",
+                    s.mean(), s.values.empty() ? 0 : *lo, s.values.empty() ? 0 : *hi);
+                std::fprintf(f, "        <standardDeviation value=\"%.1f\"/>\n", s.stddev());
+                std::fprintf(f, "      </BenchmarkResults>\n");
+            }
+            std::fprintf(f, "    </Section>\n");
+        }
+        std::fprintf(f, "  </TestCase>\n");
+    }
+    std::fprintf(f, "</Catch2TestRun>\n");
+}
+
+}
+
+/**
+ * Headless ansipp vs ncurses benchmark: identical scripted scenes are rendered into pseudo-terminal,
+ * CPU time, output bytes and latency to first byte are reported per frame as Catch2-like XML.
+ *
+ * Usage: ansipp_bench_ncurses [test case] [--out file] [--benchmark-samples frames]
+ * (arguments are compatible with `benchmark.py`, other Catch2 arguments are ignored)
+ */
+int main(int argc, char** argv) {
+    std::string_view filter;
+    const char* out_path = nullptr;
+    unsigned int frames = 100;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) out_path = argv[++i];
+        else if (arg == "--benchmark-samples" && i + 1 < argc) frames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--reporter" && i + 1 < argc) ++i;
+        else if (!arg.starts_with("-")) filter = arg;
+    }
+
+    std::vector<std::vector<measurement>> results;
+    std::vector<screen_api> apis;
+    int report_fd;
+    {
+        pty_harness pty(cols, rows);
+        report_fd = dup(pty.report_fd());
+
+        ansipp_screen ansipp_impl;
+        apis.push_back(screen_api { "ansipp",
+            [&] { ansipp_impl.open(); },
+            [&](const std::vector<scene_cell>& cells) { ansipp_impl.frame(cells); },
+            [&] { ansipp_impl.close(); } });
+
+        std::FILE* in = fdopen(dup(pty.slave_fd()), "r");
+        apis.push_back(screen_api { "ncurses",
+            [&] { ncurses_open("xterm-256color", stdout, in); },
+            [&](const std::vector<scene_cell>& cells) { ncurses_frame(cells); },
+            [&] { ncurses_close(); } });
+
+        for (const screen_api& api: apis) {
+            std::vector<measurement>& r = results.emplace_back();
+            for (unsigned int percent: percents) r.push_back(measure(pty, api, percent, frames));
+        }
+        std::fclose(in);
+    }
+
+    std::FILE* out = out_path != nullptr ? std::fopen(out_path, "w") : fdopen(report_fd, "w");
+    if (out == nullptr) return EXIT_FAILURE;
+    write_xml(out, filter, apis, results);
+    std::fclose(out);
+    if (out_path != nullptr) close(report_fd);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,30 @@
+#include "ncurses_scene.hpp"
+
+#include <curses.h>
+
+namespace {
+SCREEN* bench_screen = nullptr;
+}
+
+void ncurses_open(const char* term, std::FILE* out, std::FILE* in) {
+    bench_screen = newterm(term, out, in);
+    set_term(bench_screen);
+    noecho();
+    curs_set(0);
+    start_color();
+    for (short c = 0; c < 8; ++c) init_pair(static_cast<short>(c + 1), c, COLOR_BLACK);
+    refresh();
+}
+
+void ncurses_frame(const std::vector<scene_cell>& cells) {
+    for (const scene_cell& c: cells) {
+        mvaddch(c.y, c.x, static_cast<chtype>(static_cast<unsigned char>(c.ch)) | COLOR_PAIR(c.color + 1));
+    }
+    refresh();
+}
+
+void ncurses_close() {
+    endwin();
+    delscreen(bench_screen);
+    bench_screen = nullptr;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+#include "scene.hpp"
+
+// curses.h defines macros (`move`, `erase`, `refresh`, ...) which clash with ansipp names,
+// so ncurses side of benchmark lives in separate translation unit behind this interface
+
+/**
+ * @brief initializes ncurses screen over specified streams (`newterm`) with 8 color pairs
+ */
+void ncurses_open(const char* term, std::FILE* out, std::FILE* in);
+
+/**
+ * @brief applies cell updates and refreshes screen (ncurses computes and writes the difference)
+ */
+void ncurses_frame(const std::vector<scene_cell>& cells);
+
+void ncurses_close();
@@ -0,0 +1,125 @@
+#include <cstdlib>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include <ansipp.hpp>
+
+#include "pty_harness.hpp"
+
+using namespace ansipp;
+
+// every write syscall made by the library (and this benchmark) to `stdout` is counted
+extern "C" ssize_t write(int fd, const void* buf, size_t size) {
+    if (fd == STDOUT_FILENO) pty_harness::count_write();
+    return syscall(SYS_write, fd, buf, size);
+}
+
+extern "C" ssize_t writev(int fd, const iovec* iov, int count) {
+    if (fd == STDOUT_FILENO) pty_harness::count_write();
+    return syscall(SYS_writev, fd, iov, count);
+}
+
+namespace {
+
+struct workloads {
+    charbuf out = charbuf(64 * 1024);
+    vec size;
+
+    std::size_t flush() {
+        const std::size_t bytes = out.size();
+        // pty accepts only part of big frames, remaining data is written with subsequent calls
+        for (std::string_view data = out.flush(); !data.empty();) {
+            const std::streamsize w = stdout_write(data);
+            if (w < 0) break;
+            data.remove_prefix(static_cast<std::size_t>(w));
+        }
+        return bytes;
+    }
+
+    // every cell is redrawn with its own color
+    std::size_t full_repaint(std::uint64_t frame) {
+        for (int y = 0; y < size.y; ++y) {
+            out << move_abs(1, y + 1);
+            for (int x = 0; x < size.x; ++x) {
+                out << attrs().fg(static_cast<color>((x + y + frame) % 8)) << static_cast<char>('a' + (x + frame) % 26);
+            }
+        }
+        out << attrs();
+        return flush();
+    }
+
+    // a few cells in random places are updated (status indicators, cursors of other users, etc)
+    std::size_t sparse_updates(std::uint64_t frame) {
+        std::uint32_t seed = static_cast<std::uint32_t>(frame) * 2654435761U + 1;
+        for (int i = 0; i < 32; ++i) {
+            seed = seed * 1664525U + 1013904223U;
+            const int x = static_cast<int>((seed >> 8) % static_cast<std::uint32_t>(size.x));
+            const int y = static_cast<int>((seed >> 20) % static_cast<std::uint32_t>(size.y));
+            out << move_abs(x + 1, y + 1) << attrs().fg(static_cast<color>(seed % 8), true) << '#';
+        }
+        out << attrs();
+        return flush();
+    }
+
+    // 24-bit background gradient, the heaviest SGR traffic
+    std::size_t gradient(std::uint64_t frame) {
+        const rgb from(static_cast<int>(frame % 256), 0, 128);
+        const rgb to(0, 255, static_cast<int>(255 - frame % 256));
+        for (int y = 0; y < size.y; ++y) {
+            out << move_abs(1, y + 1);
+            for (int x = 0; x < size.x; ++x) {
+                out << attrs().bg(rgb::lerp(from, to, static_cast<float>(x + y) / static_cast<float>(size.x + size.y))) << ' ';
+            }
+        }
+        out << attrs();
+        return flush();
+    }
+
+    // scrolling log, a few colored lines per frame
+    std::size_t log_tail(std::uint64_t frame) {
+        static constexpr std::string_view levels[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+        static constexpr color colors[] = { WHITE, GREEN, YELLOW, RED };
+        for (std::uint64_t i = 0; i < 4; ++i) {
+            const std::size_t level = (frame + i) % 4;
+            out << attrs().fg(colors[level]) << levels[level] << attrs()
+                << " frame " << frame << " line " << i << ": request processed in " << fixed_format((frame % 1000) * 0.37, 2) << " ms\r\n";
+        }
+        return flush();
+    }
+};
+
+}
+
+/**
+ * End-to-end output benchmark: renders representative workloads through `stdout_write` into pseudo-terminal.
+ *
+ * Usage: ansipp_bench_pty [frames]
+ */
+int main(int argc, char** argv) {
+    const std::uint64_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+
+    std::vector<pty_result> results;
+    int report_fd;
+    {
+        pty_harness pty(200, 60);
+        report_fd = dup(pty.report_fd());
+
+        workloads w;
+        w.size = get_terminal_size();
+        w.out << alternate_buffer.on();
+        pty.wait_drained(w.flush());
+
+        results.push_back(pty_run(pty, "full_repaint", frames, [&](std::uint64_t i) { return w.full_repaint(i); }));
+        results.push_back(pty_run(pty, "sparse_updates", frames, [&](std::uint64_t i) { return w.sparse_updates(i); }));
+        results.push_back(pty_run(pty, "gradient", frames, [&](std::uint64_t i) { return w.gradient(i); }));
+        results.push_back(pty_run(pty, "log_tail", frames, [&](std::uint64_t i) { return w.log_tail(i); }));
+
+        w.out << alternate_buffer.off();
+        w.flush();
+    }
+    pty_report(report_fd, results);
+    close(report_fd);
+    return 0;
+}
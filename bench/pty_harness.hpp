@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#if defined(__APPLE__)
+#   include <util.h>
+#else
+#   include <pty.h>
+#endif
+
+/**
+ * @brief end-to-end output benchmark environment: `stdout` is redirected to pseudo-terminal slave,
+ *  master side is drained by background thread (like terminal emulator which never lags behind).
+ *
+ * Raw mode is set on slave, so amount of drained bytes equals amount of written bytes.
+ * Write syscalls are counted by `write`/`writev` wrappers defined in benchmark executable (`count_write`).
+ */
+class pty_harness {
+    int master = -1;
+    int slave = -1;
+    int saved_stdout = -1;
+    std::atomic<bool> stop = false;
+    std::atomic<std::uint64_t> drained = 0;
+    std::atomic<bool> marked = false;
+    std::atomic<std::int64_t> first_byte = 0;
+    std::thread drain_thread;
+
+    static std::int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void drain() {
+        char buf[64 * 1024];
+        pollfd pfd = { master, POLLIN, 0 };
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (poll(&pfd, 1, 10) <= 0) continue;
+            const ssize_t r = read(master, buf, sizeof(buf));
+            if (r <= 0) continue;
+            if (marked.exchange(false, std::memory_order_acq_rel)) first_byte.store(now_ns(), std::memory_order_release);
+            drained.fetch_add(static_cast<std::uint64_t>(r), std::memory_order_relaxed);
+        }
+    }
+
+public:
+    static inline std::atomic<std::uint64_t> write_calls = 0;
+
+    /**
+     * @brief call from `write`/`writev` wrappers for `STDOUT_FILENO`
+     */
+    static void count_write() { write_calls.fetch_add(1, std::memory_order_relaxed); }
+
+    pty_harness(unsigned short cols, unsigned short rows) {
+        winsize ws = {};
+        ws.ws_col = cols;
+        ws.ws_row = rows;
+        if (openpty(&master, &slave, nullptr, nullptr, &ws) == -1) throw std::runtime_error("openpty failed");
+
+        termios t;
+        tcgetattr(slave, &t);
+        cfmakeraw(&t);
+        tcsetattr(slave, TCSANOW, &t);
+
+        std::fflush(stdout);
+        saved_stdout = dup(STDOUT_FILENO);
+        dup2(slave, STDOUT_FILENO);
+        drain_thread = std::thread(&pty_harness::drain, this);
+    }
+
+    pty_harness(const pty_harness&) = delete;
+    pty_harness& operator=(const pty_harness&) = delete;
+
+    ~pty_harness() {
+        stop = true;
+        drain_thread.join();
+        dup2(saved_stdout, STDOUT_FILENO);
+        close(saved_stdout);
+        close(slave);
+        close(master);
+    }
+
+    /**
+     * @brief waits until master side received `bytes` bytes in total
+     */
+    void wait_drained(std::uint64_t bytes) const {
+        while (drained.load(std::memory_order_relaxed) < bytes) std::this_thread::yield();
+    }
+
+    std::uint64_t drained_bytes() const { return drained.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief waits until all written data is drained (when amount of written bytes isn't known, i.e. `stdio` output)
+     */
+    void settle() const {
+        pollfd pfd = { master, POLLIN, 0 };
+        for (std::uint64_t before = drained_bytes();; before = drained_bytes()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (poll(&pfd, 1, 0) == 0 && drained_bytes() == before) return;
+        }
+    }
+
+    /**
+     * @brief starts latency measurement, output must be settled
+     * @return start timestamp
+     */
+    std::int64_t mark() {
+        first_byte.store(0, std::memory_order_relaxed);
+        marked.store(true, std::memory_order_release);
+        return now_ns();
+    }
+
+    /**
+     * @brief waits for first byte written after `mark()`
+     * @return nanoseconds between `mark()` and arrival of first byte on master side or `-1` if nothing was written within 100ms
+     */
+    std::int64_t wait_first_byte(std::int64_t start) const {
+        std::int64_t t;
+        while ((t = first_byte.load(std::memory_order_acquire)) == 0) {
+            if (now_ns() - start > 100'000'000) return -1;
+            std::this_thread::yield();
+        }
+        return t - start;
+    }
+
+    int slave_fd() const { return slave; }
+
+    /**
+     * @brief original `stdout` (for reports)
+     */
+    int report_fd() const { return saved_stdout; }
+};
+
+struct pty_result {
+    std::string name;
+    std::uint64_t frames = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t syscalls = 0;
+    double seconds = 0;
+
+    double bytes_per_frame() const { return frames == 0 ? 0 : static_cast<double>(bytes) / frames; }
+    double syscalls_per_frame() const { return frames == 0 ? 0 : static_cast<double>(syscalls) / frames; }
+    double fps() const { return seconds == 0 ? 0 : frames / seconds; }
+};
+
+/**
+ * @brief runs `frame(index)` `frames` times, `frame` returns amount of bytes it wrote to `stdout`
+ */
+inline pty_result pty_run(pty_harness& pty, const std::string& name, std::uint64_t frames, const std::function<std::size_t(std::uint64_t)>& frame) {
+    pty_result r;
+    r.name = name;
+    r.frames = frames;
+    const std::uint64_t drained_before = pty.drained_bytes();
+    const std::uint64_t calls_before = pty_harness::write_calls.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < frames; ++i) r.bytes += frame(i);
+    pty.wait_drained(drained_before + r.bytes);
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    r.syscalls = pty_harness::write_calls.load() - calls_before;
+    return r;
+}
+
+inline void pty_report(int fd, const std::vector<pty_result>& results) {
+    dprintf(fd, "%-20s %10s %14s %14s %12s\n", "workload", "frames", "bytes/frame", "syscalls/frame", "frames/sec");
+    for (const pty_result& r: results) {
+        dprintf(fd, "%-20s %10llu %14.1f %14.2f %12.1f\n",
+            r.name.c_str(), static_cast<unsigned long long>(r.frames), r.bytes_per_frame(), r.syscalls_per_frame(), r.fps());
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief cell update of scripted scene, same for every compared library
+ */
+struct scene_cell {
+    int x;
+    int y;
+    char ch;
+    unsigned char color; // 0..7, ANSI color order
+};
+
+/**
+ * @brief deterministic scene: `percent` of all cells change each frame, cells are ordered by row and column
+ */
+inline void scene_frame(std::uint64_t frame, unsigned int percent, int cols, int rows, std::vector<scene_cell>& cells) {
+    cells.clear();
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            std::uint32_t h = static_cast<std::uint32_t>(frame * 0x9E3779B1U) ^ static_cast<std::uint32_t>(y * cols + x);
+            h ^= h >> 16; h *= 0x7feb352dU; h ^= h >> 15; h *= 0x846ca68bU; h ^= h >> 16;
+            if (h % 100 >= percent) continue;
+            cells.push_back(scene_cell { x, y, static_cast<char>('a' + (h >> 8) % 26), static_cast<unsigned char>((h >> 16) % 8) });
+        }
+    }
+}
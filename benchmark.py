@@ -16,10 +16,10 @@ test_executable = build_dir / "ansipp_test"
 def build():
     subprocess.run(["cmake", "--workflow", "--preset benchmark"]).check_returncode()
 
-def run_benchmark(name: str, report: pathlib.Path):
+def run_benchmark(executable: pathlib.Path, name: str, report: pathlib.Path):
     report.parent.mkdir(parents=True, exist_ok=True)
     subprocess.run([
-        test_executable, name, 
+        executable, name, 
         "--reporter", "xml", 
         "--benchmark-samples", "40",
         "--out", str(report)
@@ -38,6 +38,7 @@ def parse_report_params(params: str) -> dict[str, str]:
 @dataclass
 class Report:
     xlabel: str = ""
+    ylabel: str = "nanos"
     xtick: float | None = None
     data: dict[str, tuple[list[float], list[float]]] = field(default_factory=dict)
 
@@ -48,6 +49,8 @@ def parse_report(path: pathlib.Path) -> Report:
         params = parse_report_params(section_name)
         if "xlabel" in params: 
             result.xlabel = params["xlabel"]
+        if "ylabel" in params: 
+            result.ylabel = params["ylabel"]
         if "xtick" in params: 
             result.xtick = float(params["xtick"])
         x_value = float(params["x"])
@@ -65,7 +68,7 @@ def plot(report: Report):
     ax = plt.subplot()
     if report.xlabel:
         ax.set_xlabel(report.xlabel)
-    ax.set_ylabel("nanos")
+    ax.set_ylabel(report.ylabel)
     if report.xtick is not None:
         ax.xaxis.set_major_locator(plticker.MultipleLocator(report.xtick))
     for k, v in report.data.items():
@@ -77,10 +80,12 @@ if __name__ == "__main__":
     p = argparse.ArgumentParser()
     p.add_argument("name")
     p.add_argument("-r", "--rerun", action="store_true")
+    p.add_argument("-e", "--executable", default=test_executable.name, 
+                   help="benchmark executable in build directory (i.e. ansipp_bench_ncurses)")
     a = p.parse_args()
     report_file = get_report_file(a.name)
     if not report_file.exists() or a.rerun:
         build()
-        run_benchmark(a.name, report_file)
+        run_benchmark(build_dir / a.executable, a.name, report_file)
     plot(parse_report(report_file))
 
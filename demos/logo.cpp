@@ -65,6 +65,7 @@ public:
     constexpr static int screen_width = 80;
 
     mutable charbuf out;
+    mutable sgr_cache sgr; // gradient repeats the same few colors every frame
 
     c_logo logo;
     c_terminal terminal;
@@ -120,7 +121,7 @@ void c_logo::draw(const ctrl& c) const {
             v.x = 0;
             ++v.y;
         } else {
-            c.out << attrs().fg(pos_to_rgb(v)) << std::string_view(p, cw) << attrs();
+            c.out << c.sgr.get(packed_attrs().fg(pos_to_rgb(v))) << std::string_view(p, cw) << attrs();
             ++v.x;
         }
         p += cw;
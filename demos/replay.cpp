@@ -0,0 +1,65 @@
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <ansipp.hpp>
+
+using namespace ansipp;
+
+/**
+ * Replays output of asciicast v2 recording (`asciicast_recorder`).
+ *
+ * Usage: ansipp_demo_replay <file.cast> [--speed N | --max]
+ *
+ * With `--max` events are written without delays and throughput is reported to `stderr`,
+ * so recording of real session doubles as deterministic output benchmark.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        stderr_write("usage: ansipp_demo_replay <file.cast> [--speed N | --max]\n");
+        return EXIT_FAILURE;
+    }
+    double speed = 1;
+    bool max_speed = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--max") max_speed = true;
+        else if (arg == "--speed" && i + 1 < argc) speed = std::strtod(argv[++i], nullptr);
+    }
+
+    std::error_code ec;
+    asciicast_reader reader;
+    if (reader.open(ec, argv[1]), ec) {
+        stderr_write((charbuf(256) << "can't open " << argv[1] << ": " << ec.message() << '\n').view());
+        return EXIT_FAILURE;
+    }
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start = clock::now();
+    std::uint64_t bytes = 0, events = 0;
+    for (asciicast_event e; reader.next(e);) {
+        if (e.type != 'o') continue;
+        if (!max_speed && speed > 0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(e.time / speed)));
+        }
+        for (std::string_view data = e.data; !data.empty();) {
+            const std::streamsize w = stdout_write(data);
+            if (w < 0) return EXIT_FAILURE;
+            data.remove_prefix(static_cast<std::size_t>(w));
+        }
+        bytes += e.data.size();
+        ++events;
+    }
+
+    if (max_speed) {
+        const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+        charbuf report(256);
+        report << attrs() << "\nreplayed " << events << " events, " << bytes << " bytes in " << fixed_format(seconds, 3) << "s: "
+            << fixed_format(seconds > 0 ? bytes / seconds / (1024 * 1024) : 0.0, 1) << " MiB/s, "
+            << fixed_format(seconds > 0 ? events / seconds : 0.0, 0) << " events/s\n";
+        stderr_write(report.view());
+    }
+    return EXIT_SUCCESS;
+}
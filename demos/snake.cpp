@@ -1,3 +1,4 @@
+#include <cstdio>
 #include <iostream>
 #include <thread>
 #include <algorithm>
@@ -67,11 +68,12 @@ public:
     using hr_clock = std::chrono::high_resolution_clock;
     std::size_t frame_ns;
     
-    charbuf out;
+    frame_builder out;
+    shared_segment border;
     char input_buffer[512];
     std::deque<direction> input_queue;
 
-    snake_game(): out(4096) {
+    snake_game(): out(4096), border(record_border()) {
         for (unsigned int i = 0; i < initial_snake_length; i++) {
             snake[vec(i, 0)] = direction::RIGHT;
         }
@@ -172,19 +174,26 @@ public:
         process_apples();
     }
 
+    // static part of border: top line with help and side walls, spliced into each frame without formatting
+    static shared_segment record_border() {
+        return record_segment([](charbuf& out) {
+            out << attrs().bg(WHITE).fg(BLACK);
+
+            std::size_t top_offset = out.size();
+            out << " press q to exit, <arrows> to move, <space> to pause/unpause" 
+                << fill_cells(' ', static_cast<unsigned int>(border_size.x - (out.size() - top_offset)));
+            for (int y = 0; y < grid_size.y; y++) {
+                out << move(CURSOR_DOWN_START) << ' ' << move(CURSOR_TO_COLUMN, border_size.x) << ' ';
+            }
+            out << move(CURSOR_DOWN_START);
+        }, 1024);
+    }
+
     void draw_border() {
         out << fill('\n', border_size.y) // reserve space
             << move(CURSOR_UP_START, border_size.y)
-            << attrs().bg(WHITE).fg(BLACK);
-
-        std::size_t top_offset = out.size();
-        out << " press q to exit, <arrows> to move, <space> to pause/unpause" 
-            << fill(' ', border_size.x - (out.size() - top_offset));
-        for (int y = 0; y < grid_size.y; y++) {
-            out << move(CURSOR_DOWN_START) << ' ' << move(CURSOR_TO_COLUMN, border_size.x) << ' ';
-        }
+            << border;
 
-        out << move(CURSOR_DOWN_START);        
         std::size_t bottom_offset = out.size();
         out << " frame=" << frame_ns
             << " head=" << head
@@ -192,7 +201,7 @@ public:
             << " game_over=" << game_over
             << " apples=" << apples.size()
             << " length=" << length
-            << fill(' ', border_size.x - (out.size() - bottom_offset))
+            << fill_cells(' ', static_cast<unsigned int>(border_size.x - (out.size() - bottom_offset)))
             << attrs() << '\n' 
             << move(CURSOR_UP, grid_size.y + 1) << move(CURSOR_TO_COLUMN, 2);
     }
@@ -251,7 +260,7 @@ public:
             out << move(CURSOR_DOWN, grid_size.y + 1) << move(CURSOR_TO_COLUMN, 0);
             draw_rows = border_size.y;
         }
-        out << charbuf::to_stdout;
+        out << frame_builder::to_stdout;
     }
 
     void loop() {
@@ -271,8 +280,33 @@ public:
 
 };
 
-int main() {
-    init_or_exit(config { .disable_input_signal = true, .hide_cursor = true });
+int main(int argc, char** argv) {
+    init_or_exit(config { .disable_input_signal = true, .hide_cursor = true, .detect_capabilities = true });
+
+    // `snake --record file.cast` records session, replay it with `ansipp_demo_replay file.cast`
+    // `snake --trace file.json` traces keypress to output latency (open in chrome://tracing or Perfetto)
+    const std::string_view option = argc > 2 ? argv[1] : "";
+    asciicast_recorder recorder;
+    latency_tracer tracer;
+    if (option == "--record") {
+        if (std::error_code ec; recorder.start(ec, argv[2], get_terminal_size(), true), ec) {
+            stderr_write((charbuf(256) << "can't record: " << ec.message() << '\n').view());
+            return 1;
+        }
+    } else if (option == "--trace") {
+        set_io_tap(&tracer);
+    }
     snake_game().loop();
+
+    if (option == "--trace") {
+        set_io_tap(nullptr);
+        if (std::FILE* f = std::fopen(argv[2], "w")) {
+            tracer.write_chrome_trace(f);
+            std::fclose(f);
+        }
+        const latency_histogram h = tracer.histogram();
+        stderr_write((charbuf(256) << "keypress to output latency: p50 < " << h.percentile_ns(0.5) / 1000 
+            << "us, p99 < " << h.percentile_ns(0.99) / 1000 << "us, max " << h.max_ns / 1000 << "us\n").view());
+    }
     return 0;
 }
@@ -1,13 +1,26 @@
 #include <ansipp/integral.hpp>
 #include <ansipp/charbuf.hpp>
+#include <ansipp/resource.hpp>
+#include <ansipp/static_charbuf.hpp>
+#include <ansipp/format.hpp>
 #include <ansipp/esc.hpp>
 #include <ansipp/error.hpp>
 #include <ansipp/io.hpp> 
 #include <ansipp/config.hpp>
 #include <ansipp/terminal.hpp>
+#include <ansipp/caps.hpp>
+#include <ansipp/session.hpp>
 #include <ansipp/attrs.hpp>
 #include <ansipp/cursor.hpp>
 #include <ansipp/restore.hpp>
 #include <ansipp/init.hpp>
 #include <ansipp/util.hpp>
-#include <ansipp/mouse.hpp>
\ No newline at end of file
+#include <ansipp/mouse.hpp>
+#include <ansipp/sink.hpp>
+#include <ansipp/render_pool.hpp>
+#include <ansipp/splice.hpp>
+#include <ansipp/record.hpp>
+#include <ansipp/stats.hpp>
+#include <ansipp/trace.hpp>
+#include <ansipp/frame.hpp>
+#include <ansipp/sgr_cache.hpp>
\ No newline at end of file
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <vector>
 
 #include <ansipp/esc.hpp>
 #include <ansipp/charbuf.hpp>
+#include <ansipp/session.hpp>
 
 namespace ansipp {
 
@@ -54,6 +56,24 @@ struct rgb {
             static_cast<unsigned char>(std::lerp(a.b, b.b, factor))
         };
     }
+
+    /**
+     * @brief nearest entry of 256-color palette: 6x6x6 color cube (16-231) or grayscale ramp (232-255)
+     */
+    constexpr unsigned char to_256() const {
+        constexpr int levels[] = { 0, 95, 135, 175, 215, 255 };
+        constexpr auto cube = [](int v) { return v < 48 ? 0 : v < 115 ? 1 : (v - 35) / 40; };
+        constexpr auto dist = [](int r0, int g0, int b0, int r1, int g1, int b1) {
+            return (r0 - r1) * (r0 - r1) + (g0 - g1) * (g0 - g1) + (b0 - b1) * (b0 - b1);
+        };
+        const int cr = cube(r), cg = cube(g), cb = cube(b);
+        const int avg = (r + g + b) / 3;
+        const int gray = avg > 238 ? 23 : avg < 3 ? 0 : (avg - 3) / 10;
+        const int gv = 8 + 10 * gray;
+        return dist(r, g, b, gv, gv, gv) < dist(r, g, b, levels[cr], levels[cg], levels[cb])
+            ? static_cast<unsigned char>(232 + gray)
+            : static_cast<unsigned char>(16 + 36 * cr + 6 * cg + cb);
+    }
 };
 
 /**
@@ -116,15 +136,19 @@ public:
      * @param bright bright mode (odd terminal support)
      * @return self
      */
-    attrs& c(bool bg, color v, bool bright) { return a(cb(bg, 30) + (bright ? 90 : 0) + v); }
+    attrs& c(bool bg, color v, bool bright) { return a(cb(bg, 30) + (bright ? 60 : 0) + v); }
     
     /**
      * @brief sets specified foreground/background RGB color
+     * @details mapped to nearest 8-bit color if current session doesn't support truecolor (`session::truecolor`)
      * @param bg `false` - foreground, `true` - background
      * @param v color to set
      * @return self
      */
-    attrs& c(bool bg, const rgb& v) { return a(cb(bg)).a(2).a(v.r).a(v.g).a(v.b); }
+    attrs& c(bool bg, const rgb& v) { 
+        if (!current_session().truecolor) return c(bg, v.to_256());
+        return a(cb(bg)).a(2).a(v.r).a(v.g).a(v.b); 
+    }
     
     /**
      * @brief sets specified foreground/background 8-bit color
@@ -217,25 +241,121 @@ public:
      */
     attrs& off() { return a(0); }
 
-    template <typename Stream>
-    Stream& out(Stream& s) const {
-        s << csi;
+    /**
+     * @brief upper bound of escape length: each parameter takes at most 4 bytes (3 digits and separator)
+     */
+    std::size_t max_size() const { return csi.size() + params.size() * 4 + 1; }
 
+    char* write_to(char* ptr) const {
+        ptr = write_str(ptr, csi);
         auto it = params.begin();
         const auto end = params.end();
         if (it != end) {
-            s << static_cast<unsigned int>(*it);
+            ptr = u10small(ptr, *it);
             ++it;
-            for (; it != end; ++it) s << ';' << static_cast<unsigned int>(*it);
-        } 
-        s << 'm';
-        return s;
+            for (; it != end; ++it) {
+                *ptr++ = ';';
+                ptr = u10small(ptr, *it);
+            }
+        }
+        *ptr = 'm';
+        return ptr + 1;
     }
 
 };
-template <typename Stream>
-inline Stream& operator<<(Stream& s, const attrs& a) { 
-    return a.out(s);
-}
+
+/**
+ * @brief complete SGR state packed into 64-bit key (i.e. `sgr_cache` key):
+ *  optional reset, enabled styles, foreground and background colors.
+ *
+ * Unlike `attrs` it has no parameter list, so it's trivially copyable and comparable,
+ * parameters are written in canonical order: `0` (reset), styles ascending, foreground, background.
+ *
+ * | Bits  | Field                                                          |
+ * |-------|----------------------------------------------------------------|
+ * | 0-8   | styles (`BOLD` - bit 0, ..., `STRIKETHROUGH` - bit 8)          |
+ * | 9     | reset                                                          |
+ * | 10-12 | foreground kind (`color_kind`)                                 |
+ * | 13-36 | foreground value (color and bright flag, 8-bit index or RGB)   |
+ * | 37-39 | background kind                                                |
+ * | 40-63 | background value                                               |
+ */
+struct packed_attrs {
+    enum color_kind: unsigned int { KEEP, DEFAULT, BASIC, INDEXED, RGB };
+
+    std::uint64_t key = 0;
+
+    constexpr packed_attrs() = default;
+    constexpr explicit packed_attrs(std::uint64_t key): key(key) {}
+
+    static constexpr unsigned int reset_bit = 9;
+    static constexpr unsigned int fg_shift = 10;
+    static constexpr unsigned int bg_shift = 37;
+
+    constexpr packed_attrs& c(bool bg, color_kind kind, std::uint32_t value = 0) {
+        const unsigned int shift = bg ? bg_shift : fg_shift;
+        key = (key & ~(std::uint64_t(0x7ffffff) << shift)) | (std::uint64_t(kind) | std::uint64_t(value & 0xffffff) << 3) << shift;
+        return *this;
+    }
+    constexpr packed_attrs& c(bool bg, color v, bool bright) { return c(bg, BASIC, v | (bright ? 8 : 0)); }
+    constexpr packed_attrs& c(bool bg, const rgb& v) { return c(bg, RGB, std::uint32_t(v.r) << 16 | std::uint32_t(v.g) << 8 | v.b); }
+    constexpr packed_attrs& c(bool bg, unsigned char v) { return c(bg, INDEXED, v); }
+    constexpr packed_attrs& c(bool bg) { return c(bg, DEFAULT); }
+
+    constexpr packed_attrs& fg(color v, bool bright = false) { return c(false, v, bright); }
+    constexpr packed_attrs& fg(const rgb& v) { return c(false, v); }
+    constexpr packed_attrs& fg(unsigned char v) { return c(false, v); }
+    constexpr packed_attrs& fg() { return c(false); }
+    constexpr packed_attrs& bg(color v, bool bright = false) { return c(true, v, bright); }
+    constexpr packed_attrs& bg(const rgb& v) { return c(true, v); }
+    constexpr packed_attrs& bg(unsigned char v) { return c(true, v); }
+    constexpr packed_attrs& bg() { return c(true); }
+    constexpr packed_attrs& on(style s) { key |= std::uint64_t(1) << (s - 1); return *this; }
+
+    /**
+     * @brief resets all styles and colors before applying the rest
+     */
+    constexpr packed_attrs& off() { key |= std::uint64_t(1) << reset_bit; return *this; }
+
+    constexpr bool operator==(const packed_attrs&) const = default;
+
+    /**
+     * @brief upper bound of escape length: 20 parameters (reset, 9 styles, 2 RGB colors) of at most 4 bytes
+     */
+    static constexpr std::size_t max_size() { return csi.size() + 20 * 4 + 1; }
+
+    /**
+     * @brief writes SGR escape, RGB colors are mapped to 8-bit if current session doesn't support truecolor
+     */
+    char* write_to(char* ptr) const {
+        ptr = write_str(ptr, csi);
+        char* const params = ptr;
+        auto param = [&](unsigned int v) { ptr = u10small(ptr, v); *ptr++ = ';'; };
+        if (key >> reset_bit & 1) param(0);
+        for (unsigned int s = 0; s < 9; ++s) if (key >> s & 1) param(s + 1);
+        for (const bool bg: { false, true }) {
+            const std::uint64_t field = key >> (bg ? bg_shift : fg_shift);
+            const std::uint32_t value = static_cast<std::uint32_t>(field >> 3 & 0xffffff);
+            const unsigned int base = bg ? 10 : 0;
+            switch (field & 7) {
+            case DEFAULT: param(39 + base); break;
+            case BASIC: param(30 + base + (value & 7) + (value & 8 ? 60 : 0)); break;
+            case INDEXED: param(38 + base); param(5); param(value); break;
+            case RGB:
+                param(38 + base);
+                if (current_session().truecolor) {
+                    param(2); param(value >> 16); param(value >> 8 & 0xff); param(value & 0xff);
+                } else {
+                    param(5); param(rgb(static_cast<int>(value)).to_256());
+                }
+                break;
+            default: break;
+            }
+        }
+        if (ptr != params) --ptr; // trailing separator
+        *ptr = 'm';
+        return ptr + 1;
+    }
+};
 
 }
\ No newline at end of file
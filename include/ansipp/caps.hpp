@@ -0,0 +1,145 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace ansipp {
+
+/**
+ * @brief terminal capabilities detected by `detect_caps()`
+ */
+struct terminal_caps {
+    /**
+     * @brief 24-bit colors (`attrs::fg(rgb)`), detected by `COLORTERM` or known terminal name
+     */
+    bool truecolor = false;
+
+    /**
+     * @brief synchronized output mode (`?2026`), frames are presented atomically
+     */
+    bool synchronized_output = false;
+
+    /**
+     * @brief SGR mouse encoding (`?1006`)
+     */
+    bool mouse_sgr = false;
+
+    /**
+     * @brief bracketed paste mode (`?2004`)
+     */
+    bool bracketed_paste = false;
+
+    /**
+     * @brief focus reporting mode (`?1004`)
+     */
+    bool focus_reporting = false;
+
+    /**
+     * @brief sixel graphics (DA1 attribute `4`)
+     */
+    bool sixel = false;
+
+    /**
+     * @brief DA1 conformance level (`62` - VT220 and above), `-1` if terminal didn't reply
+     */
+    int da1_class = -1;
+
+    /**
+     * @brief DA2 terminal type and firmware version, `-1` if terminal didn't reply
+     */
+    int da2_type = -1;
+    int da2_version = -1;
+
+    /**
+     * @brief XTVERSION reply (i.e. `kitty(0.35.2)`), empty if terminal didn't reply
+     */
+    std::string version;
+
+    /**
+     * @brief terminal answered primary device attributes, so all other replies (or their absence) are reliable
+     */
+    bool answered = false;
+
+    bool operator==(const terminal_caps&) const = default;
+};
+
+/**
+ * @brief batch of all capability queries, primary device attributes (DA1) is the last one:
+ *  every terminal answers it and replies come in order, so its reply terminates the batch.
+ */
+constexpr std::string_view caps_query =
+    "\x1b[?2026$p"  // DECRQM synchronized output
+    "\x1b[?1006$p"  // DECRQM SGR mouse
+    "\x1b[?2004$p"  // DECRQM bracketed paste
+    "\x1b[?1004$p"  // DECRQM focus reporting
+    "\x1b[>0q"      // XTVERSION
+    "\x1b[>c"       // DA2
+    "\x1b[c";       // DA1
+
+/**
+ * @brief parses replies to `caps_query`, unknown bytes (i.e. keys pressed during probe) are skipped
+ * @param replies raw terminal input
+ * @param caps detected capabilities are set, other fields are kept as is
+ * @return `true` if DA1 reply was found (batch is complete)
+ */
+bool parse_caps_replies(std::string_view replies, terminal_caps& caps);
+
+/**
+ * @brief cache key of current terminal, built from `TERM`, `TERM_PROGRAM`, `TERM_PROGRAM_VERSION`
+ *  and emulator specific environment variables (`VTE_VERSION`, `KITTY_WINDOW_ID`, ...).
+ * @return empty string if terminal can't be identified (i.e. only `TERM` is set, which is shared by many emulators),
+ *  such terminals aren't cached
+ */
+std::string caps_cache_key();
+
+/**
+ * @brief default cache file: `$XDG_CACHE_HOME/ansipp/caps` or `~/.cache/ansipp/caps`
+ *  (`%LOCALAPPDATA%\ansipp\caps` on Windows), empty if none of variables is set
+ */
+std::string caps_cache_path();
+
+/**
+ * @brief one line of cache file
+ */
+std::string serialize_caps(std::string_view key, const terminal_caps& caps);
+
+/**
+ * @brief parses one line of cache file
+ * @return `true` if line is valid and its key is equal to `key`
+ */
+bool deserialize_caps(std::string_view line, std::string_view key, terminal_caps& caps);
+
+/**
+ * @brief looks up `key` in cache file
+ * @return `true` if entry was found
+ */
+bool load_caps(const std::string& path, std::string_view key, terminal_caps& caps);
+
+/**
+ * @brief replaces (or appends) `key` entry in cache file, creates parent directory if needed
+ * @return `false` if file couldn't be written
+ */
+bool save_caps(const std::string& path, std::string_view key, const terminal_caps& caps);
+
+/**
+ * @brief sends `caps_query` in single write and collects replies with single deadline.
+ *
+ * Terminal must be initialized with disabled input echo (default `config`), otherwise replies are echoed
+ * and may be delayed until `Enter` is pressed.
+ *
+ * @param timeout total timeout in milliseconds
+ */
+terminal_caps probe_caps(int timeout = 200);
+
+/**
+ * @brief returns cached capabilities of current terminal or probes it and stores result into cache.
+ *
+ * Only complete probes (`terminal_caps::answered`) are cached, so slow terminal will be probed again next time.
+ * Terminals without cache key (`caps_cache_key()`) are probed every time.
+ *
+ * @param timeout probe timeout in milliseconds
+ * @param path cache file, empty - disables cache
+ */
+terminal_caps detect_caps(int timeout = 200, const std::string& path = caps_cache_path());
+
+}
@@ -4,25 +4,124 @@
 #include <cstring> // std::memcpy
 #include <bit> // std::bit_ceil
 #include <new> // bad_alloc
+#include <stdexcept> // length_error
 #include <string>
 #include <string_view>
 #include <charconv>
 #include <concepts>
+#include <cmath> // std::signbit, std::llrint
+#include <type_traits> // std::common_type_t, std::is_signed_v
+#include <limits>
 
 #include <ansipp/integral.hpp>
+#include <ansipp/util.hpp>
 #include <ansipp/io.hpp>
+#include <ansipp/stats.hpp>
 
 namespace ansipp {
 
+/**
+ * @brief integral value with explicit base, zero padded `width` (digits and sign, `0` - natural length),
+ *  and optional field padding and digit grouping, i.e. table cell:
+ * ```
+ * out << integral_format(bytes).grouping(',').pad(16); // "       1,048,576"
+ * ```
+ * Total length is computed upfront with `ulen`, so whole cell is written with single reserve.
+ */
 template <std::integral T>
 struct integral_format {
     T value;
     unsigned int base;
     bool upper;
     unsigned int width;
+    unsigned int field = 0;
+    align_type alignment = RIGHT;
+    char fill_char = ' ';
+    char separator = '\0';
+    unsigned int group = 3;
 
     integral_format(T value, unsigned int base = 10, bool upper = false, unsigned int width = 0):
         value(value), base(base), upper(upper), width(width) {}
+
+    /**
+     * @brief pads formatted value with `fill_char` up to `field` chars (longer values are not truncated)
+     */
+    integral_format& pad(unsigned int field, align_type alignment = RIGHT, char fill_char = ' ') {
+        this->field = field;
+        this->alignment = alignment;
+        this->fill_char = fill_char;
+        return *this;
+    }
+
+    /**
+     * @brief inserts `separator` between each `group` digits counting from the right
+     */
+    integral_format& grouping(char separator, unsigned int group = 3) {
+        this->separator = separator;
+        this->group = group == 0 ? 1 : group;
+        return *this;
+    }
+
+    /**
+     * @brief whether only `base`, `upper` and `width` are used
+     */
+    bool plain() const { return field == 0 && separator == '\0'; }
+
+    bool negative() const {
+        if constexpr (std::is_signed_v<T>) return value < 0; else return false;
+    }
+
+    std::uintmax_t magnitude() const {
+        if constexpr (std::is_signed_v<T>) return iabs(value); else return value;
+    }
+
+    unsigned int digits() const {
+        return width == 0 ? ulen(magnitude(), base) : width - static_cast<unsigned int>(negative());
+    }
+
+    /**
+     * @brief length of sign and digits with separators (without field padding)
+     */
+    unsigned int body_size() const {
+        const unsigned int d = digits();
+        return static_cast<unsigned int>(negative()) + d + (separator == '\0' || d == 0 ? 0 : (d - 1) / group);
+    }
+
+    /**
+     * @brief total amount of written chars
+     */
+    unsigned int size() const { return (std::max)(field, body_size()); }
+
+    /**
+     * @brief writes exactly `size()` chars
+     * @return end of written chars
+     */
+    char* write_to(char* buf) const {
+        const unsigned int body = body_size();
+        const unsigned int total = (std::max)(field, body);
+        const unsigned int left = align(alignment, total, body);
+        std::memset(buf, fill_char, left);
+        char* ptr = buf + left;
+        if (negative()) *ptr++ = '-';
+        const unsigned int d = digits();
+        if (separator == '\0') {
+            uchars(ptr, d, magnitude(), base, upper);
+            ptr += d;
+        } else if (d != 0) {
+            // digits are written at the end of grouped body and moved left group by group,
+            // group never moves past the start of its source, so width isn't limited by scratch buffer
+            char* src = ptr + (d - 1) / group;
+            uchars(src, d, magnitude(), base, upper);
+            unsigned int chunk = (d - 1) % group + 1;
+            for (unsigned int i = 0; i < d; i += chunk, src += chunk, chunk = group) {
+                if (i != 0) *ptr++ = separator;
+                std::memmove(ptr, src, chunk);
+                ptr += chunk;
+            }
+        }
+        std::memset(ptr, fill_char, total - body - left);
+        return ptr + (total - body - left);
+    }
 };
 
 template <std::floating_point T>
@@ -35,12 +134,183 @@ struct floating_format {
         value(value), format(format), precision(precision) {}
 };
 
+/**
+ * @brief fixed-point decimal with `precision` fraction digits (same output as `std::chars_format::fixed`)
+ *  for bounded values (metrics, percents, timings).
+ *
+ * Value is scaled by `10^precision`, rounded once and written as integer with `uchars`,
+ * values with `|value| * 10^precision >= 1e18`, NaN and infinity fall back to `std::to_chars`.
+ * Scaling isn't exact, so the last digit may differ from `std::to_chars` when value is within an ulp of rounding tie.
+ */
+template <std::floating_point T>
+struct fixed_format {
+    T value;
+    unsigned int precision;
+
+    fixed_format(T value, unsigned int precision = 2): value(value), precision(precision) {}
+};
+
+/**
+ * @brief buffer size required by `fixed_chars`: sign, 19 digits, decimal point
+ */
+constexpr std::size_t fixed_chars_max = 21;
+
+/**
+ * @brief writes `v` to `buf` which has at least `fixed_chars_max` bytes
+ * @return end of written chars or `nullptr` if value is out of fast path range (nothing is written in this case)
+ */
+template <std::floating_point T>
+char* fixed_chars(char* buf, fixed_format<T> v) {
+    if (v.precision > 17) return nullptr;
+    const std::uint64_t scale = v.precision == 0 ? 1 : ipow_lookup<10>::data.pow[v.precision - 1];
+    const bool negative = std::signbit(v.value);
+    // float is scaled in double precision, so the product doesn't introduce new rounding ties
+    using S = std::common_type_t<T, double>;
+    const S scaled = static_cast<S>(negative ? -v.value : v.value) * static_cast<S>(scale);
+    if (!(scaled < static_cast<S>(1e18))) return nullptr; // also NaN
+    const std::uint64_t fixed = static_cast<std::uint64_t>(std::llrint(scaled));
+
+    if (negative) *buf++ = '-';
+    const std::uint64_t integer = fixed / scale;
+    const unsigned int len = ulen10(integer);
+    uchars(buf, len, integer, 10, false);
+    buf += len;
+    if (v.precision == 0) return buf;
+    *buf++ = '.';
+    uchars(buf, v.precision, fixed % scale, 10, false);
+    return buf + v.precision;
+}
+
+/**
+ * @brief escape (or other item) which knows upper bound of its length and can be written without bounds checks.
+ *
+ * `max_size()` - upper bound of written bytes (`write_to` may touch all of them), 
+ * `write_to(ptr)` - writes escape to `ptr` and returns end of written chars.
+ * Buffers reserve `max_size()` once and pass raw pointer to `write_to` instead of per-piece writes.
+ */
+template <typename T>
+concept sized_escape = requires(const T& e, char* ptr) {
+    { e.max_size() } -> std::convertible_to<std::size_t>;
+    { e.write_to(ptr) } -> std::same_as<char*>;
+};
+
+/**
+ * @brief copies `s` to `ptr` (`sized_escape::write_to` helper)
+ */
+inline char* write_str(char* ptr, std::string_view s) { std::memcpy(ptr, s.data(), s.size()); return ptr + s.size(); }
+
+/**
+ * @brief buffer which gives raw access to reserved memory (`charbuf`, `fixed_charbuf_base`), 
+ *  such buffers write `sized_escape`s in place with their own `operator<<`
+ */
+template <typename Stream>
+concept raw_buffer = requires(Stream& s, std::size_t size) {
+    { s.reserve(size) } -> std::same_as<char*>;
+};
+
+/**
+ * @brief writes `sized_escape` to other streams (i.e. `std::ostream`) through temporary buffer
+ */
+template <typename Stream, sized_escape T> requires (!raw_buffer<Stream>)
+Stream& operator<<(Stream& s, const T& e) {
+    char stack[128];
+    const std::size_t max = e.max_size();
+    if (max <= sizeof(stack)) {
+        s << std::string_view(stack, e.write_to(stack));
+    } else {
+        std::string heap(max, '\0');
+        s << std::string_view(heap.data(), e.write_to(heap.data()));
+    }
+    return s;
+}
+
+/**
+ * @brief unsigned decimal which is expected to be small (SGR parameter, screen coordinate), 
+ *  values below `1000` are written with single table lookup instead of `ulen10` + `uchars`
+ */
+struct small_uint {
+    unsigned int value;
+    constexpr explicit small_uint(unsigned int value): value(value) {}
+
+    static constexpr std::size_t max_size() { return std::numeric_limits<unsigned int>::digits10 + 1; }
+    char* write_to(char* ptr) const {
+        if (value < 1000) [[likely]] return u10small(ptr, value);
+        const unsigned int len = ulen10(value);
+        uchars(ptr, len, value, 10, false);
+        return ptr + len;
+    }
+};
+
 struct fill {
     char ch;
     std::size_t count;
     fill(char ch, std::size_t count): ch(ch), count(count) {}
 };
 
+/**
+ * @brief pluggable memory source for `charbuf` storage.
+ * 
+ * Unlike `std::pmr::memory_resource` it has `reallocate` which allows implementations 
+ * to grow blocks in place (like `std::realloc` or bump arena tail extension).
+ * 
+ * @see arena_charbuf_resource
+ * @see pmr_charbuf_resource
+ */
+class charbuf_resource {
+public:
+    virtual ~charbuf_resource() = default;
+
+    /**
+     * @brief allocates new block or resizes existing one
+     * @param ptr block to resize or `nullptr` to allocate new one
+     * @param size current block size (`0` if `ptr == nullptr`)
+     * @param used amount of bytes at the beginning of block which must be preserved
+     * @param new_size requested block size
+     * @return resized block or `nullptr` if memory can't be allocated (`ptr` remains valid in this case)
+     */
+    virtual void* reallocate(void* ptr, std::size_t size, std::size_t used, std::size_t new_size) = 0;
+
+    /**
+     * @brief releases block previously returned by `reallocate`
+     */
+    virtual void deallocate(void* ptr, std::size_t size) = 0;
+};
+
+enum growth_strategy: unsigned char {
+    /**
+     * @brief capacity is rounded up to power of 2 (default, the fastest to converge)
+     */
+    GROW_POW2,
+
+    /**
+     * @brief capacity grows at least 1.5x of current one (less slack on large buffers)
+     */
+    GROW_1_5X,
+
+    /**
+     * @brief capacity is exactly required size (many reallocations, no slack)
+     */
+    GROW_EXACT
+};
+
+/**
+ * @brief memory policy of `charbuf`
+ */
+struct charbuf_policy {
+    growth_strategy growth = GROW_POW2;
+
+    /**
+     * @brief capacity limit, `0` - unlimited. Writes beyond it throw `std::length_error`
+     */
+    std::size_t max_capacity = 0;
+
+    /**
+     * @brief shrinks buffer after `decay_frames` consecutive frames (`flush()` or `reset()`) 
+     *  which used at most quarter of capacity, new capacity fits the largest of those frames. `0` - never shrink
+     */
+    unsigned int decay_frames = 0;
+};
+
 /**
  * Simple and fast mix of `std::string` and `std::stringstream`.
  * 
@@ -60,24 +330,83 @@ class charbuf {
     char* b;
     char* e;
     char* p;
+    charbuf_resource* r; // `nullptr` - `std::realloc` and `std::free`
+    charbuf_policy pol;
+    unsigned int small_frames = 0;
+    std::size_t small_peak = 0;
+
+    void release() {
+        if (r == nullptr) std::free(b); else if (b != nullptr) r->deallocate(b, e - b);
+    }
 
-    void resize_pow2(std::size_t sz) {
-        char* nb = static_cast<char*>(std::realloc(b, sz));
+    // reallocates block to exactly `sz` bytes
+    void resize_exact(std::size_t sz) {
+        char* nb = static_cast<char*>(r == nullptr ? std::realloc(b, sz) : r->reallocate(b, e - b, p - b, sz));
         if (nb == nullptr) [[unlikely]] throw std::bad_alloc();
+        ANSIPP_STATS_ADD(charbuf_reallocs, 1);
+        ANSIPP_STATS_ADD(charbuf_realloc_bytes, sz);
         p = nb + (p - b);
         b = nb;
         e = b + sz;
     }
 
+    std::size_t grow_size(std::size_t required) const {
+        std::size_t sz;
+        switch (pol.growth) {
+        case GROW_EXACT: sz = required; break;
+        case GROW_1_5X: sz = (std::max)(required, capacity() + capacity() / 2); break;
+        default: sz = std::bit_ceil(required); break;
+        }
+        sz = (std::max)(min_alloc_sz, sz);
+        if (pol.max_capacity != 0) [[unlikely]] {
+            if (required > pol.max_capacity) throw std::length_error("charbuf: max capacity exceeded");
+            sz = (std::min)(sz, pol.max_capacity);
+        }
+        return sz;
+    }
+
     void resize(std::size_t sz) {
-        resize_pow2((std::max)(min_alloc_sz, std::bit_ceil(sz)));
+        resize_exact(grow_size(sz));
+    }
+
+    // frame of `used` bytes is complete, its bytes are still in buffer
+    void end_frame(std::size_t used) {
+        if (pol.decay_frames == 0) [[likely]] return;
+        if (used > capacity() / 4) {
+            small_frames = 0;
+            small_peak = 0;
+            return;
+        }
+        small_peak = (std::max)(small_peak, used);
+        if (++small_frames < pol.decay_frames) return;
+        const std::size_t target = (std::max)(min_alloc_sz, pol.growth == GROW_POW2 ? std::bit_ceil(small_peak) : small_peak);
+        small_frames = 0;
+        small_peak = 0;
+        if (target < capacity()) resize_exact(target);
+    }
+
+    template <std::integral T>
+    charbuf& write_padded(const integral_format<T>& v) {
+        require(v.size());
+        p = v.write_to(p);
+        return *this;
     }
 
 public:
-    charbuf(): b(nullptr), e(nullptr), p(nullptr) {}
+    charbuf(): b(nullptr), e(nullptr), p(nullptr), r(nullptr) {}
     charbuf(std::size_t initial_size): charbuf() { resize(initial_size); }
-    charbuf(charbuf&& mv): b(mv.b), e(mv.e), p(mv.p) { mv.b = mv.e = mv.p = nullptr; }
-    ~charbuf() { std::free(b); }
+    charbuf(std::size_t initial_size, const charbuf_policy& policy): charbuf() { pol = policy; resize(initial_size); }
+    
+    /**
+     * @brief creates buffer which takes memory from specified resource, resource must outlive buffer
+     */
+    explicit charbuf(charbuf_resource& resource): b(nullptr), e(nullptr), p(nullptr), r(&resource) {}
+    charbuf(charbuf_resource& resource, std::size_t initial_size): charbuf(resource) { resize(initial_size); }
+
+    charbuf(charbuf&& mv): b(mv.b), e(mv.e), p(mv.p), r(mv.r), pol(mv.pol), small_frames(mv.small_frames), small_peak(mv.small_peak) { 
+        mv.b = mv.e = mv.p = nullptr; 
+    }
+    ~charbuf() { release(); }
 
     void require(std::size_t size) {
         char* np = p + size;
@@ -91,14 +420,25 @@ public:
         return r;
     }
 
+    /**
+     * @brief current write position, bytes up to `end()` can be written directly after `require()`
+     */
+    char* pos() { return p; }
+
+    /**
+     * @brief marks bytes written directly up to `end` (must be in `[pos(), end()]`) as used
+     */
+    void commit(char* end) { p = end; }
+
     charbuf& operator=(charbuf&& mv) {
-        std::free(b);
-        b = mv.b; e = mv.e; p = mv.p;
+        release();
+        b = mv.b; e = mv.e; p = mv.p; r = mv.r;
+        pol = mv.pol; small_frames = mv.small_frames; small_peak = mv.small_peak;
         mv.b = mv.e = mv.p = nullptr;
         return *this;
     }
 
-    charbuf& reset() { p = b; return *this; }
+    charbuf& reset() { end_frame(size()); p = b; return *this; }
     char* begin() { return b; }
     const char* begin() const { return b; }
     char* end() { return e; }
@@ -106,9 +446,25 @@ public:
     char* data() { return b; }
     const char* data() const { return b; }
     std::size_t capacity() const { return e - b; }
+    charbuf_resource* resource() const { return r; }
     std::size_t size() const { return p - b; }
     std::string_view view() const { return std::string_view(b, p); }
-    std::string_view flush() { char* pe = p; p = b; return std::string_view(b, pe); }
+    std::string_view flush() { end_frame(size()); char* pe = p; p = b; return std::string_view(b, pe); }
+
+    const charbuf_policy& policy() const { return pol; }
+
+    /**
+     * @brief changes memory policy, applied on next reallocation (current capacity isn't changed)
+     */
+    void set_policy(const charbuf_policy& policy) { pol = policy; small_frames = 0; small_peak = 0; }
+
+    /**
+     * @brief reduces capacity to `max(size, size())`, data is preserved
+     */
+    void shrink_to(std::size_t size) {
+        const std::size_t target = (std::max)({ size, this->size(), min_alloc_sz });
+        if (target < capacity()) resize_exact(target);
+    }
     std::string str() const { return std::string(b, p); }
     
     // compatibility with std::back_inserter
@@ -131,6 +487,7 @@ public:
 
     template <std::unsigned_integral T>
     charbuf& operator<<(const integral_format<T>& v) {
+        if (!v.plain()) return write_padded(v);
         unsigned int width = v.width == 0 ? ulen(v.value, v.base) : v.width;
         uchars(reserve(width), width, v.value, v.base, v.upper);
         return *this;
@@ -143,8 +500,26 @@ public:
         return *this;
     }
 
+    template <sized_escape T>
+    charbuf& operator<<(const T& e) {
+        require(e.max_size());
+        p = e.write_to(p);
+        return *this;
+    }
+
+    /**
+     * @brief writes batch of escapes with single capacity check
+     */
+    template <sized_escape... T>
+    charbuf& write(const T&... escapes) {
+        require((static_cast<std::size_t>(escapes.max_size()) + ... + 0));
+        ((p = escapes.write_to(p)), ...);
+        return *this;
+    }
+
     template <std::signed_integral T>
     charbuf& operator<<(integral_format<T> v) {
+        if (!v.plain()) return write_padded(v);
         unsigned int width = v.width == 0 ? ilen(v.value, v.base) : v.width;
         ichars(reserve(width), width, v.value, v.base, v.upper);
         return *this;
@@ -176,6 +551,16 @@ public:
         return *this;
     }
 
+    template <std::floating_point T>
+    charbuf& operator<<(fixed_format<T> v) {
+        require(fixed_chars_max);
+        if (char* r = fixed_chars(p, v)) [[likely]] {
+            p = r;
+            return *this;
+        }
+        return *this << floating_format(v.value, std::chars_format::fixed, static_cast<int>(v.precision));
+    }
+
     template <std::floating_point T>
     charbuf& operator<<(T v) { return *this << floating_format(v); }
 
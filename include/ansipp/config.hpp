@@ -59,6 +59,17 @@ struct config {
      */
     enum mouse_encoding mouse_encoding = MOUSE_UTF8;
 
+    /**
+     * @brief detects terminal capabilities (`detect_caps()`) and selects the most compact encodings
+     *  supported by terminal for the session (`current_session()`), i.e. SGR mouse encoding overrides `mouse_encoding`
+     */
+    bool detect_capabilities = false;
+
+    /**
+     * @brief capability probe timeout in milliseconds, used only when capabilities aren't cached yet
+     */
+    int detect_timeout = 200;
+
     /**
      * @brief additional custom init string, useful to initialize some additional modes using raw escape sequences
      * @details note that after init(std::error_code, config) call any modifications to this string will be ignored
@@ -62,50 +62,56 @@ struct move {
     move_mode mode; 
     unsigned int value; 
     move(move_mode mode, unsigned int value = 1): mode(mode), value(value) {}
+
+    static constexpr std::size_t max_size() { return csi.size() + small_uint::max_size() + 1; }
+    char* write_to(char* ptr) const {
+        if (mode == CURSOR_TO_COLUMN && value < 2) { *ptr = '\r'; return ptr + 1; }
+        if (value == 0) return ptr;
+        ptr = write_str(ptr, csi);
+        if (value > 1) ptr = small_uint(value).write_to(ptr);
+        *ptr = static_cast<char>(mode);
+        return ptr + 1;
+    }
 };
-template <typename Stream>
-Stream& operator<<(Stream& s, move op) {
-    if (op.mode == CURSOR_TO_COLUMN && op.value < 2) return s << '\r';
-    if (op.value == 0) return s;
-    s << csi;
-    if (op.value > 1) s << op.value;
-    s << static_cast<char>(op.mode);
-    return s;
-}
 
 struct move_rel { 
     int x, y; 
     move_rel(int x, int y): x(x), y(y) {}
     move_rel(const vec& v): x(v.x), y(v.y) {}
+
+    move horizontal() const {
+        return x < 0 ? move(CURSOR_LEFT, static_cast<unsigned int>(-x)) : move(CURSOR_RIGHT, static_cast<unsigned int>(x));
+    }
+    move vertical() const {
+        return y < 0 ? move(CURSOR_UP, static_cast<unsigned int>(-y)) : move(CURSOR_DOWN, static_cast<unsigned int>(y));
+    }
+
+    static constexpr std::size_t max_size() { return 2 * move::max_size(); }
+    char* write_to(char* ptr) const { return vertical().write_to(horizontal().write_to(ptr)); }
 };
-template <typename Stream>
-Stream& operator<<(Stream& s, move_rel op) {
-    s << (op.x < 0 
-        ? move(CURSOR_LEFT, static_cast<unsigned int>(-op.x)) 
-        : move(CURSOR_RIGHT, static_cast<unsigned int>(op.x)));
-    s << (op.y < 0 
-        ? move(CURSOR_UP, static_cast<unsigned int>(-op.y))
-        : move(CURSOR_DOWN, static_cast<unsigned int>(op.y)));
-    return s;
-}
 
 struct move_abs { 
     int x, y; 
     move_abs(int x, int y): x(x), y(y) {}
     move_abs(const vec& v): x(v.x), y(v.y) {}
+
+    static constexpr std::size_t max_size() { return csi.size() + 2 * small_uint::max_size() + 2; }
+    char* write_to(char* ptr) const {
+        ptr = write_str(ptr, csi);
+        if (y > 1) ptr = small_uint(static_cast<unsigned int>(y)).write_to(ptr);
+        if (x > 1) {
+            *ptr++ = ';';
+            ptr = small_uint(static_cast<unsigned int>(x)).write_to(ptr);
+        }
+        *ptr = 'H';
+        return ptr + 1;
+    }
 };
-template <typename Stream>
-Stream& operator<<(Stream& s, move_abs op) { 
-    s << csi;
-    if (op.y > 1) s << op.y;
-    if (op.x > 1) s << ';' << op.x;
-    return s << 'H';
-}
 
 
-const std::string store_cursor = esc + "7";
-const std::string restore_cursor = esc + "8";
-const std::string request_cursor = csi + "6n";
+constexpr std::string_view store_cursor = "\x1b" "7";
+constexpr std::string_view restore_cursor = "\x1b" "8";
+constexpr std::string_view request_cursor = "\x1b[" "6n";
 
 enum cursor_shape: char {
     SHAPE_DEFAULT = '0',
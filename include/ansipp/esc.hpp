@@ -1,23 +1,35 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <ansipp/charbuf.hpp>
+#include <ansipp/resource.hpp>
 
 namespace ansipp {
 
-const std::string esc(1, '\x1b');
-const std::string csi = esc + '[';
-const std::string decset = csi + '?';
+// constant views: no static initialization, and length is known at compile time (fixed size copies)
+constexpr std::string_view esc = "\x1b";
+constexpr std::string_view csi = "\x1b[";
+constexpr std::string_view decset = "\x1b[?";
 
 template <typename Esc>
-std::string esc_str(const Esc& esc) { return (charbuf() << esc).str(); }
+std::string esc_str(const Esc& esc) { 
+    char storage[128];
+    arena_charbuf_resource mem(storage, sizeof(storage));
+    return (charbuf(mem) << esc).str(); 
+}
 
 struct decset_esc {
     unsigned int code;
     char suffix;
+
+    static constexpr std::size_t max_size() { return decset.size() + small_uint::max_size() + 1; }
+    char* write_to(char* ptr) const {
+        ptr = small_uint(code).write_to(write_str(ptr, decset));
+        *ptr = suffix;
+        return ptr + 1;
+    }
 };
-template <typename Stream>
-Stream& operator<<(Stream& s, decset_esc e) { return s << decset << e.code << e.suffix; }
 
 class decset_mode {
     unsigned int code;
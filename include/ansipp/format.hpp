@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <concepts>
+#include <utility>
+
+#include <ansipp/integral.hpp>
+#include <ansipp/charbuf.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief format string literal usable as template parameter
+ */
+template <std::size_t N>
+struct format_string {
+    char chars[N];
+    constexpr format_string(const char (&s)[N]) { for (std::size_t i = 0; i < N; ++i) chars[i] = s[i]; }
+    constexpr std::string_view view() const { return std::string_view(chars, N - 1); }
+};
+
+/**
+ * @brief format string split at compile time into literal pieces (`{{` and `}}` unescaped) around `{}` placeholders
+ */
+template <format_string F>
+struct format_pieces {
+
+    static constexpr std::size_t count_args() {
+        const std::string_view f = F.view();
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < f.size(); ++i) {
+            if (f[i] == '{') {
+                if (i + 1 < f.size() && f[i + 1] == '{') { ++i; continue; }
+                if (i + 1 < f.size() && f[i + 1] == '}') { ++i; ++n; continue; }
+                throw "ansipp::format: only {} placeholders are supported";
+            }
+            if (f[i] == '}') {
+                if (i + 1 < f.size() && f[i + 1] == '}') { ++i; continue; }
+                throw "ansipp::format: unmatched }";
+            }
+        }
+        return n;
+    }
+
+    static constexpr std::size_t args = count_args();
+
+    struct table_data {
+        char text[sizeof(F.chars)] = {};
+        std::size_t ends[args + 1] = {}; // ends[i] - end of i-th piece in `text`
+        std::size_t size = 0;
+        constexpr table_data() {
+            const std::string_view f = F.view();
+            std::size_t piece = 0;
+            for (std::size_t i = 0; i < f.size(); ++i) {
+                if (f[i] == '{' && f[i + 1] == '}') { ends[piece++] = size; ++i; continue; }
+                text[size++] = f[i];
+                if (f[i] == '{' || f[i] == '}') ++i; // escaped brace
+            }
+            ends[piece] = size;
+        }
+    };
+    static constexpr table_data data = {};
+
+    template <std::size_t I>
+    static constexpr std::size_t begin() { return I == 0 ? 0 : data.ends[I - 1]; }
+
+    template <std::size_t I>
+    static char* write(char* ptr) {
+        constexpr std::size_t b = begin<I>();
+        constexpr std::size_t size = data.ends[I] - b;
+        if constexpr (size != 0) std::memcpy(ptr, data.text + b, size);
+        return ptr + size;
+    }
+};
+
+/**
+ * @brief upper bound of chars written by `format_write` for the same argument
+ */
+inline std::size_t format_size(char) { return 1; }
+inline std::size_t format_size(bool) { return 1; }
+inline std::size_t format_size(std::string_view s) { return s.size(); }
+inline std::size_t format_size(const char* s) { return std::strlen(s); }
+template <std::integral T>
+constexpr std::size_t format_size(T) { return std::numeric_limits<T>::digits10 + 1 + std::is_signed_v<T>; }
+template <sized_escape T>
+std::size_t format_size(const T& e) { return e.max_size(); }
+
+/**
+ * @brief writes argument without bounds checks, at least `format_size(v)` bytes must be available
+ * @return end of written chars
+ */
+inline char* format_write(char* ptr, char v) { *ptr = v; return ptr + 1; }
+inline char* format_write(char* ptr, bool v) { *ptr = v ? '1' : '0'; return ptr + 1; }
+inline char* format_write(char* ptr, std::string_view s) { return write_str(ptr, s); }
+inline char* format_write(char* ptr, const char* s) { return write_str(ptr, s); }
+template <sized_escape T>
+char* format_write(char* ptr, const T& e) { return e.write_to(ptr); }
+template <std::unsigned_integral T>
+char* format_write(char* ptr, T v) {
+    const unsigned int len = ulen10(v);
+    uchars(ptr, len, v, 10, false);
+    return ptr + len;
+}
+template <std::signed_integral T>
+char* format_write(char* ptr, T v) {
+    const unsigned int len = ilen(v, 10);
+    ichars(ptr, len, v, 10, false);
+    return ptr + len;
+}
+
+/**
+ * @brief writes `args` into `out` using format string `F` parsed at compile time.
+ *
+ * Only `{}` placeholders are supported (`{{` and `}}` are literal braces),
+ * arguments are integers, chars, bools, strings and `sized_escape`s (`small_uint`, `move_abs`, `attrs`, etc).
+ * Worst-case size is computed upfront, so there is single `require()` and all pieces are written without bounds checks.
+ *
+ * ```
+ * ansipp::format<"\33[{};{}H">(out, y, x);
+ * ```
+ */
+template <format_string F, typename... Args>
+charbuf& format(charbuf& out, const Args&... args) {
+    using pieces = format_pieces<F>;
+    static_assert(pieces::args == sizeof...(Args), "ansipp::format: arguments count doesn't match placeholders");
+
+    out.require(pieces::data.size + (format_size(args) + ... + 0));
+    char* ptr = pieces::template write<0>(out.pos());
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((ptr = pieces::template write<I + 1>(format_write(ptr, args))), ...);
+    }(std::index_sequence_for<Args...>{});
+    out.commit(ptr);
+    return out;
+}
+
+}
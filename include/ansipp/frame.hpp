@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <ansipp/charbuf.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief immutable formatted fragment shared by reference (static UI parts: borders, headers, legends).
+ *
+ * Copies share the same bytes, so segment can be spliced into any amount of frames without copying.
+ * Segment created from `charbuf` takes its storage (buffer's resource must outlive all copies of segment).
+ */
+class shared_segment {
+    std::shared_ptr<const charbuf> buf;
+
+public:
+    shared_segment() = default;
+
+    /**
+     * @brief takes storage of recorded buffer, content isn't copied
+     */
+    explicit shared_segment(charbuf&& recorded): buf(std::make_shared<const charbuf>(std::move(recorded))) {}
+
+    /**
+     * @brief copies `data` to new segment
+     */
+    explicit shared_segment(std::string_view data): shared_segment(std::move(charbuf(data.size()) << data)) {}
+
+    std::string_view view() const { return buf == nullptr ? std::string_view() : buf->view(); }
+    const char* data() const { return view().data(); }
+    std::size_t size() const { return buf == nullptr ? 0 : buf->size(); }
+    bool empty() const { return size() == 0; }
+};
+
+/**
+ * @brief records fragment once: `draw(charbuf&)` formats it into new buffer which becomes segment
+ * ```
+ * shared_segment legend = record_segment([&](charbuf& out) { out << attrs().fg(YELLOW) << " q - exit " << attrs(); });
+ * ```
+ */
+template <typename F>
+shared_segment record_segment(F&& draw, std::size_t initial_size = 256) {
+    charbuf buf(initial_size);
+    std::forward<F>(draw)(buf);
+    return shared_segment(std::move(buf));
+}
+
+/**
+ * @brief frame which mixes freshly formatted output with spliced `shared_segment`s.
+ *
+ * Dynamic parts are formatted into `buffer()` as usual, segments are referenced at their position in frame
+ * and passed to `writev` together with buffer ranges around them (`flush()`), so unchanged parts
+ * of the frame cost neither formatting nor copying. Segments not longer than `inline_threshold`
+ * are copied into buffer instead: `memcpy` of few bytes is cheaper than separate `iovec`.
+ *
+ * ```
+ * frame_builder out;
+ * out << move(CURSOR_UP_START, rows) << border << "score: " << score << frame_builder::to_stdout;
+ * ```
+ */
+class frame_builder {
+    struct splice_point {
+        std::size_t offset; // buffer size when segment was spliced
+        shared_segment segment;
+    };
+
+    charbuf buf;
+    std::vector<splice_point> splices;
+    std::vector<std::string_view> iov;
+    std::size_t spliced_bytes = 0;
+    std::size_t inline_max;
+
+public:
+    static constexpr std::size_t default_inline_threshold = 128;
+
+    explicit frame_builder(std::size_t initial_size = 4096, std::size_t inline_threshold = default_inline_threshold):
+        buf(initial_size), inline_max(inline_threshold) {}
+
+    /**
+     * @brief buffer for dynamic parts of current frame
+     */
+    charbuf& buffer() { return buf; }
+    const charbuf& buffer() const { return buf; }
+
+    /**
+     * @brief reserves bytes in `buffer()` (makes frame `raw_buffer`, so escapes are written in place)
+     */
+    char* reserve(std::size_t size) { return buf.reserve(size); }
+
+    /**
+     * @brief references segment at current position, segment is kept alive until frame is flushed or reset
+     */
+    frame_builder& operator<<(const shared_segment& s) {
+        if (s.size() <= inline_max) {
+            buf << s.view();
+        } else {
+            splices.push_back({ buf.size(), s });
+            spliced_bytes += s.size();
+        }
+        return *this;
+    }
+
+    template <typename T>
+    frame_builder& operator<<(const T& v) { buf << v; return *this; }
+
+    frame_builder& operator<<(void(*fn)(frame_builder&)) { fn(*this); return *this; }
+
+    // `charbuf::to_stdout` would flush only buffer, without spliced segments
+    frame_builder& operator<<(void(*fn)(charbuf&)) = delete;
+
+    /**
+     * @brief total size of frame, including spliced segments
+     */
+    std::size_t size() const { return buf.size() + spliced_bytes; }
+
+    /**
+     * @brief amount of segments referenced (not inlined) by current frame
+     */
+    std::size_t splice_count() const { return splices.size(); }
+
+    /**
+     * @brief frame as ordered list of buffer ranges and segments (empty ranges are skipped),
+     *  valid until next write to frame
+     */
+    const std::vector<std::string_view>& parts();
+
+    /**
+     * @brief copy of whole frame
+     */
+    std::string str() const;
+
+    /**
+     * @brief drops current frame and references to its segments
+     */
+    void reset();
+
+    /**
+     * @brief writes frame to `stdout` with single gather write and resets it
+     * @return amount of bytes written or `-1` in case of error
+     */
+    std::streamsize flush();
+
+    static void to_stdout(frame_builder& f) { f.flush(); }
+};
+
+}
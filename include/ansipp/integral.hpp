@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 #include <concepts>
 #include <limits>
@@ -9,10 +10,22 @@
 #include <bit>
 
 // by default only decimals are optimized
+// 0x01 - base 2 lookup table
+// 0x02 - base 8 lookup table
+// 0x04 - base 10 lookup table
+// 0x08 - base 16 (upper) lookup table
+// 0x10 - base 16 (lower) lookup table
+// 0x20 - base 10 SWAR (8 digits per step using 64-bit multiply-shift)
+// 0x40 - base 10 SSE2 (16 digits per step, x86 only, ignored on other platforms)
 #ifndef ANSIPP_FAST_INTEGRAL
 #define ANSIPP_FAST_INTEGRAL 0x04
 #endif
 
+#if (ANSIPP_FAST_INTEGRAL & 0x40) != 0 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define ANSIPP_FAST_INTEGRAL_SSE2
+#   include <emmintrin.h>
+#endif
+
 namespace ansipp {
 
 constexpr char digit(unsigned int v, bool upper = false) { 
@@ -74,6 +87,37 @@ struct ichars_lookup {
     constexpr static table_data data = {};
 };
 
+/**
+ * @brief decimal lookup table for small values `[0, 1000)` (SGR parameters, screen coordinates)
+ * @details each entry is 4 bytes: up to 3 left-aligned digits and length in last byte,
+ *  so any value can be written with single 4-byte copy. Table requires 4kb of memory.
+ */
+template <unsigned int size = 1000>
+struct u10small_lookup {
+    struct table_data {
+        char chars[size][4];
+        constexpr table_data(): chars() {
+            for (unsigned int v = 0; v < size; ++v) {
+                const unsigned int len = v < 10 ? 1 : v < 100 ? 2 : 3;
+                for (unsigned int c = len, n = v; c-- > 0; n /= 10) chars[v][c] = digit(n % 10);
+                chars[v][3] = static_cast<char>(len);
+            }
+        }
+    };
+    constexpr static table_data data = {};
+};
+
+/**
+ * @brief writes value < 1000 using `u10small_lookup`
+ * @param buf output buffer, must have at least 4 writable bytes regardless of value length
+ * @return pointer past last written digit
+ */
+constexpr char* u10small(char* buf, unsigned int value) {
+    const char* e = u10small_lookup<>::data.chars[value];
+    std::copy_n(e, 4, buf);
+    return buf + e[3];
+}
+
 constexpr std::uintmax_t iabs(std::intmax_t v) {
     const auto uv = static_cast<std::uintmax_t>(v);
     if (v >= 0) return uv;
@@ -131,11 +175,98 @@ constexpr void ulookupchars(char* buf, unsigned int len, std::uintmax_t value) {
     if (len > 0) std::copy_n(l.chars[value % lookup::pow] + digits - len, len, buf);
 }
 
+/**
+ * @brief converts value < 10^8 to 8 decimal digits using SWAR (SIMD within a register)
+ * @details each step splits all lanes at once by multiply-shift division: 
+ *  32-bit lanes (4 digits) -> 16-bit lanes (2 digits) -> 8-bit lanes (1 digit).
+ *  Most significant digit is placed in the lowest byte.
+ */
+constexpr std::uint64_t swar8(std::uint64_t value) {
+    const std::uint64_t hi = value / 10000;
+    std::uint64_t m = hi | ((value - hi * 10000) << 32);
+    std::uint64_t t = ((m * 10486) >> 20) & 0x0000007F0000007FULL; // 10486 / 2^20 ~ 1 / 100
+    m = t | ((m - 100 * t) << 16);
+    t = ((m * 103) >> 10) & 0x000F000F000F000FULL; // 103 / 2^10 ~ 1 / 10
+    m = t | ((m - 10 * t) << 8);
+    return m + 0x3030303030303030ULL;
+}
+
+constexpr void store8(char* buf, std::uint64_t chars) {
+    if (!std::is_constant_evaluated() && std::endian::native == std::endian::little) {
+        std::memcpy(buf, &chars, 8); // single unaligned 64-bit store
+        return;
+    }
+    for (unsigned int i = 0; i < 8; ++i) buf[i] = static_cast<char>(chars >> (i * 8));
+}
+
+constexpr void uswarchars(char* buf, unsigned int len, std::uintmax_t value) {
+    for (; len >= 8; value /= 100000000) {
+        len -= 8;
+        store8(buf + len, swar8(value % 100000000));
+    }
+    ulookupchars<10, 2>(buf, len, value);
+}
+
+#ifdef ANSIPP_FAST_INTEGRAL_SSE2
+/**
+ * @brief converts value < 10^8 to 8 decimal digits in 16-bit lanes (SSE2)
+ * @details algorithm by Wojciech Muła, see http://0x80.pl/articles/sse-itoa.html
+ */
+inline __m128i sse2_digits8(std::uint32_t value) {
+    const __m128i div10000 = _mm_set1_epi32(static_cast<int>(0xd1b71759));
+    const __m128i mul10000 = _mm_set1_epi32(10000);
+    const __m128i div_powers = _mm_setr_epi16(8389, 5243, 13108, -32768, 8389, 5243, 13108, -32768);
+    const __m128i shift_powers = _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13, -32768, 1 << 7, 1 << 11, 1 << 13, -32768);
+    const __m128i mul10 = _mm_set1_epi16(10);
+
+    const __m128i abcdefgh = _mm_cvtsi32_si128(static_cast<int>(value));
+    const __m128i abcd = _mm_srli_epi64(_mm_mul_epu32(abcdefgh, div10000), 45);
+    const __m128i efgh = _mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd, mul10000));
+    const __m128i v1 = _mm_slli_epi64(_mm_unpacklo_epi16(abcd, efgh), 2);
+    const __m128i v2a = _mm_unpacklo_epi16(v1, v1);
+    const __m128i v2 = _mm_unpacklo_epi32(v2a, v2a);
+    const __m128i v4 = _mm_mulhi_epu16(_mm_mulhi_epu16(v2, div_powers), shift_powers); // a, ab, abc, abcd, e, ef, ...
+    const __m128i v6 = _mm_slli_epi64(_mm_mullo_epi16(v4, mul10), 16); // 0, a0, ab0, abc0, 0, e0, ...
+    return _mm_sub_epi16(v4, v6);
+}
+
+/**
+ * @brief writes last `len` (up to 16) decimal digits of value < 10^16
+ */
+inline void sse2chars16(char* buf, unsigned int len, std::uint64_t value) {
+    const std::uint64_t hi = value / 100000000;
+    const __m128i digits = _mm_packus_epi16(
+        sse2_digits8(static_cast<std::uint32_t>(hi)), 
+        sse2_digits8(static_cast<std::uint32_t>(value - hi * 100000000)));
+    alignas(16) char chars[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(chars), _mm_add_epi8(digits, _mm_set1_epi8('0')));
+    std::copy_n(chars + 16 - len, len, buf);
+}
+
+inline void usse2chars(char* buf, unsigned int len, std::uintmax_t value) {
+    if (len <= 8) {
+#if (ANSIPP_FAST_INTEGRAL & 0x20) != 0
+        uswarchars(buf, len, value);
+#else
+        ulookupchars<10, 2>(buf, len, value);
+#endif
+        return;
+    }
+    if (len <= 16) {
+        sse2chars16(buf, len, value);
+        return;
+    }
+    constexpr std::uintmax_t p16 = 10000000000000000ULL;
+    sse2chars16(buf + len - 16, 16, value % p16);
+    ulookupchars<10, 2>(buf, len - 16, value / p16);
+}
+#endif
+
 constexpr void uchars(char* buf, unsigned int len, std::uintmax_t value, unsigned int base, bool upper) {
     // all lookup tables requires ~1,5kb of memory
     // but performance is almost the same for small numbers (~<1000, base 10)
     // the biggest impact - optimize binary (base=2) values
-#if (ANSIPP_FAST_INTEGRAL & 0x3f) != 0
+#if (ANSIPP_FAST_INTEGRAL & 0x7f) != 0
     switch (base) {
 #if (ANSIPP_FAST_INTEGRAL & 0x01) != 0
         // 2^4*4 = 64 bytes
@@ -149,10 +280,20 @@ constexpr void uchars(char* buf, unsigned int len, std::uintmax_t value, unsigne
             ulookupchars<8, 2>(buf, len, value); 
             return;
 #endif
-#if (ANSIPP_FAST_INTEGRAL & 0x04) != 0
+#if (ANSIPP_FAST_INTEGRAL & (0x04 | 0x20 | 0x40)) != 0
         // 10^2*2 = 200 bytes
         [[likely]] case 10: 
+#   ifdef ANSIPP_FAST_INTEGRAL_SSE2
+            if (!std::is_constant_evaluated()) {
+                usse2chars(buf, len, value);
+                return;
+            }
+#   endif
+#   if (ANSIPP_FAST_INTEGRAL & 0x20) != 0
+            uswarchars(buf, len, value);
+#   else
             ulookupchars<10, 2>(buf, len, value); 
+#   endif
             return;
 #endif
 #if (ANSIPP_FAST_INTEGRAL & (0x08 | 0x10)) != 0
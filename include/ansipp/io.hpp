@@ -4,9 +4,46 @@
 #include <string>
 #include <string_view>
 #include <cstddef>
+#include <span>
 
 namespace ansipp {
 
+enum io_direction {
+    IO_OUTPUT,
+    IO_INPUT
+};
+
+/**
+ * @brief observer of terminal I/O (i.e. session recorder), see `set_io_tap(io_tap*)`
+ */
+class io_tap {
+public:
+    virtual ~io_tap() = default;
+
+    /**
+     * @brief called after bytes were written to `stdout` or read from `stdin`, 
+     *  from the thread which did I/O (may be called concurrently)
+     */
+    virtual void on_io(io_direction dir, std::string_view data) = 0;
+
+    /**
+     * @brief called once after gather write (`stdout_write(std::span<const std::string_view>)`) with all its parts,
+     *  default implementation passes parts to `on_io` one by one
+     */
+    virtual void on_io_parts(io_direction dir, std::span<const std::string_view> parts) {
+        for (std::string_view part: parts) if (!part.empty()) on_io(dir, part);
+    }
+};
+
+/**
+ * @brief installs tap for all `stdout_write` and `stdin_read` calls, `nullptr` - removes tap.
+ * @details without tap I/O functions pay single relaxed atomic load.
+ *  Tap must outlive all I/O calls started before it was removed.
+ *  `stdout_write` is signal safe only if tap's `on_io` is signal safe (library taps lock and allocate, so they aren't).
+ *  Terminal restore on signals (`config::enable_signal_restore`) writes directly and bypasses the tap.
+ */
+void set_io_tap(io_tap* tap);
+
 /**
  * @brief simple non-bufferring function to write raw bytes to `stdout`.
  *
@@ -23,6 +60,17 @@ std::streamsize stdout_write(std::string_view sw);
 std::streamsize stderr_write(const void* buf, std::size_t sz);
 std::streamsize stderr_write(std::string_view sw);
 
+/**
+ * @brief gather-writes all parts to `stdout` in order using as few syscalls as possible (`writev` on POSIX).
+ * 
+ * Unlike `stdout_write(const void*, std::size_t)` partial writes are continued until all parts are written,
+ * so bytes of single call never interleave with each other.
+ * 
+ * @param parts buffers to write
+ * @return total amount of bytes was written, or `-1` in case of error
+ */
+std::streamsize stdout_write(std::span<const std::string_view> parts);
+
 /**
  * @brief simple non-bufferring function to read raw bytes from `stdin`.
  *
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include <ansipp/charbuf.hpp>
+#include <ansipp/io.hpp>
+#include <ansipp/vec.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief appends bytes as JSON string content (without quotes), valid UTF-8 sequences are kept as is.
+ * @details bytes which aren't valid UTF-8 are written as `\u00XX` (so they're replayed as 2 bytes)
+ * @param carry incomplete UTF-8 sequence at the end of `data` is moved here and prepended on the next call
+ */
+void json_escape(charbuf& out, std::string_view data, std::string& carry);
+
+/**
+ * @brief parses JSON string (starting at opening quote) into UTF-8 bytes
+ * @return position after closing quote or `std::string_view::npos` if string is malformed
+ */
+std::size_t json_unescape(std::string_view json, std::size_t pos, std::string& out);
+
+/**
+ * @brief session recorder: all terminal I/O (`stdout_write`, optionally `stdin_read`) is appended
+ *  to asciicast v2 file with timestamps.
+ *
+ * I/O threads only format event into shared buffer, file is written by background thread
+ * every `flush_interval` or when buffer grows above `flush_size`.
+ *
+ * Example:
+ * ```
+ * asciicast_recorder rec;
+ * rec.start(ec, "session.cast");
+ * ...
+ * rec.stop(); // or destructor
+ * ```
+ */
+class asciicast_recorder: public io_tap {
+    using clock = std::chrono::steady_clock;
+
+    std::FILE* file = nullptr;
+    clock::time_point started;
+    bool record_input = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    charbuf pending = charbuf(64 * 1024);
+    std::string carry[2]; // per direction
+    bool stopping = false;
+    std::thread writer;
+
+    void run();
+
+public:
+    static constexpr std::chrono::milliseconds flush_interval { 100 };
+    static constexpr std::size_t flush_size = 1024 * 1024;
+
+    asciicast_recorder() = default;
+    asciicast_recorder(const asciicast_recorder&) = delete;
+    asciicast_recorder& operator=(const asciicast_recorder&) = delete;
+    ~asciicast_recorder() override;
+
+    /**
+     * @brief creates file, writes header and installs itself as I/O tap (`set_io_tap(io_tap*)`)
+     * @param path file to create
+     * @param size terminal size stored in header
+     * @param input record input events as well (`"i"`)
+     */
+    void start(std::error_code& ec, const std::string& path, vec size, bool input = false);
+
+    /**
+     * @brief removes I/O tap, writes pending events and closes file
+     */
+    void stop();
+
+    bool recording() const { return file != nullptr; }
+
+    void on_io(io_direction dir, std::string_view data) override;
+
+    /**
+     * @brief gather write is recorded as single event
+     */
+    void on_io_parts(io_direction dir, std::span<const std::string_view> parts) override;
+};
+
+struct asciicast_event {
+    double time = 0;
+    char type = 'o';
+    std::string data;
+};
+
+/**
+ * @brief sequential reader of asciicast v2 file
+ */
+class asciicast_reader {
+    std::FILE* file = nullptr;
+    std::string line;
+
+    bool read_line();
+
+public:
+    vec size;
+
+    asciicast_reader() = default;
+    asciicast_reader(const asciicast_reader&) = delete;
+    asciicast_reader& operator=(const asciicast_reader&) = delete;
+    ~asciicast_reader();
+
+    /**
+     * @brief opens file and parses header
+     */
+    void open(std::error_code& ec, const std::string& path);
+
+    /**
+     * @brief reads next event, malformed lines are skipped
+     * @return `false` at the end of file
+     */
+    bool next(asciicast_event& e);
+
+    /**
+     * @brief parses single event line (`[time, "type", "data"]`)
+     */
+    static bool parse_event(std::string_view line, asciicast_event& e);
+};
+
+}
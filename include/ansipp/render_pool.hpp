@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <ansipp/charbuf.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief small thread pool which serializes frame rows in parallel.
+ *
+ * Rows are split to contiguous ranges, one per thread (calling thread renders first range),
+ * each range is serialized into private `charbuf`, so no synchronization is required while formatting.
+ * Resulting chunks are kept in row order and can be written with single `writev` (`flush()`)
+ * or stitched into another buffer (`append_to()`).
+ *
+ * Example:
+ * ```
+ * render_pool pool;
+ * pool.render(size.y, [&](charbuf& out, int y) { out << move_abs(1, y + 1) << rows[y]; }).flush();
+ * ```
+ */
+class render_pool {
+
+    using render_fn = void (*)(const void* ctx, charbuf& out, int row);
+
+    std::vector<charbuf> chunks;
+    std::vector<std::string_view> parts;
+    std::vector<std::exception_ptr> errors; // per chunk, set if `row_fn` threw
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::uint64_t generation = 0;
+    bool stop = false;
+    std::atomic<unsigned int> pending = 0;
+
+    render_fn fn = nullptr;
+    const void* ctx = nullptr;
+    int rows = 0;
+
+    void render_chunk(unsigned int index);
+    void worker(unsigned int index);
+    void dispatch(render_fn fn, const void* ctx, int rows);
+
+public:
+    /**
+     * @param threads total amount of threads including calling thread, `0` - use `std::thread::hardware_concurrency()`
+     */
+    explicit render_pool(unsigned int threads = 0);
+    render_pool(const render_pool&) = delete;
+    render_pool& operator=(const render_pool&) = delete;
+    ~render_pool();
+
+    unsigned int thread_count() const { return static_cast<unsigned int>(chunks.size()); }
+
+    /**
+     * @brief serializes rows `[0, rows)` by calling `row_fn(charbuf&, int row)`, blocks until all rows are done
+     * @details output is appended to previous not flushed output.
+     *  `row_fn` is called concurrently from multiple threads and must not modify shared state.
+     *  If `row_fn` throws, remaining rows of its range are skipped, all threads are waited for,
+     *  pool is reset (not flushed output is dropped) and exception of the first failed range is rethrown
+     * @return self
+     */
+    template <typename Fn>
+    render_pool& render(int rows, const Fn& row_fn) {
+        dispatch([](const void* c, charbuf& out, int row) { (*static_cast<const Fn*>(c))(out, row); }, &row_fn, rows);
+        return *this;
+    }
+
+    /**
+     * @brief rendered chunks in row order, valid until next `render()`, `flush()` or `reset()`
+     */
+    std::span<const std::string_view> view();
+
+    /**
+     * @brief appends all rendered chunks to specified buffer and resets pool
+     */
+    void append_to(charbuf& out);
+
+    /**
+     * @brief writes all rendered chunks to `stdout` using single gather write and resets pool
+     * @return result of `stdout_write(std::span<const std::string_view>)`
+     */
+    std::streamsize flush();
+
+    void reset();
+
+};
+
+}
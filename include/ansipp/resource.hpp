@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+
+#include <ansipp/charbuf.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief bump arena for short-lived `charbuf`s.
+ *
+ * Memory comes from single contiguous block (stack array or owned heap block),
+ * the most recent allocation grows in place, so typical `charbuf` growth (32, 64, 128, ...) never copies.
+ * When arena is exhausted blocks fall back to `std::malloc`.
+ *
+ * Small buffer (no heap allocation for tiny strings):
+ * ```
+ * char storage[128];
+ * arena_charbuf_resource mem(storage, sizeof(storage));
+ * charbuf cb(mem);
+ * ```
+ *
+ * Per-frame scratch buffers:
+ * ```
+ * arena_charbuf_resource frame_arena(1 << 20);
+ * for (;;) {
+ *     { charbuf scratch(frame_arena); ... }
+ *     frame_arena.reset(); // all charbufs allocated from arena must be destroyed before reset
+ * }
+ * ```
+ */
+class arena_charbuf_resource: public charbuf_resource {
+    char* begin;
+    char* end;
+    char* top;
+    char* last = nullptr;
+    bool owned;
+
+    bool contains(const char* ptr) const { return ptr >= begin && ptr < end; }
+
+    static char* allocate(std::size_t size) {
+        char* buf = static_cast<char*>(std::malloc(size));
+        if (buf == nullptr) [[unlikely]] throw std::bad_alloc();
+        return buf;
+    }
+
+public:
+    arena_charbuf_resource(char* buf, std::size_t size): begin(buf), end(buf + size), top(buf), owned(false) {}
+    explicit arena_charbuf_resource(std::size_t size): arena_charbuf_resource(allocate(size), size) { owned = true; }
+    arena_charbuf_resource(const arena_charbuf_resource&) = delete;
+    arena_charbuf_resource& operator=(const arena_charbuf_resource&) = delete;
+    ~arena_charbuf_resource() override { if (owned) std::free(begin); }
+
+    /**
+     * @brief releases all arena memory at once
+     */
+    void reset() { top = begin; last = nullptr; }
+
+    std::size_t capacity() const { return end - begin; }
+    std::size_t used() const { return top - begin; }
+
+    void* reallocate(void* ptr, std::size_t size, std::size_t used, std::size_t new_size) override {
+        char* old = static_cast<char*>(ptr);
+        if (old != nullptr && old == last && new_size <= static_cast<std::size_t>(end - old)) {
+            top = old + new_size;
+            return old;
+        }
+        if (old != nullptr && !contains(old)) return std::realloc(old, new_size);
+
+        char* nb;
+        if (new_size <= static_cast<std::size_t>(end - top)) {
+            nb = last = top;
+            top += new_size;
+        } else {
+            nb = static_cast<char*>(std::malloc(new_size));
+            if (nb == nullptr) return nullptr;
+        }
+        if (old != nullptr) {
+            std::memcpy(nb, old, used);
+            deallocate(old, size);
+        }
+        return nb;
+    }
+
+    void deallocate(void* ptr, std::size_t) override {
+        char* old = static_cast<char*>(ptr);
+        if (!contains(old)) { std::free(old); return; }
+        if (old == last) { top = old; last = nullptr; }
+    }
+
+};
+
+/**
+ * @brief adapts `std::pmr::memory_resource` to `charbuf_resource` (growth always allocates new block and copies)
+ */
+class pmr_charbuf_resource: public charbuf_resource {
+    std::pmr::memory_resource* upstream;
+public:
+    explicit pmr_charbuf_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()): upstream(upstream) {}
+
+    std::pmr::memory_resource* get_upstream() const { return upstream; }
+
+    void* reallocate(void* ptr, std::size_t size, std::size_t used, std::size_t new_size) override {
+        void* nb;
+        try {
+            nb = upstream->allocate(new_size, 1);
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+        if (ptr != nullptr) {
+            std::memcpy(nb, ptr, used);
+            upstream->deallocate(ptr, size, 1);
+        }
+        return nb;
+    }
+
+    void deallocate(void* ptr, std::size_t size) override { upstream->deallocate(ptr, size, 1); }
+
+};
+
+/**
+ * @brief page-mapped blocks for very large `charbuf`s (bulk dumps, full-screen truecolor frames).
+ *
+ * Blocks below `mmap_threshold` use `std::realloc`, larger ones are anonymous memory mappings 
+ * which grow with `mremap` on Linux: pages are remapped instead of copied, so growth cost doesn't depend on size.
+ * Blocks of at least `huge_page_threshold` bytes are advised to use transparent huge pages (`MADV_HUGEPAGE`).
+ * Other POSIX systems map new block and copy, Windows always uses `std::realloc`.
+ *
+ * Resource is stateless, single instance can be shared by any amount of buffers and threads:
+ * ```
+ * mmap_charbuf_resource mem;
+ * charbuf dump(mem, 16 << 20);
+ * ```
+ */
+class mmap_charbuf_resource: public charbuf_resource {
+    std::size_t mmap_min;
+    std::size_t huge_min;
+
+    bool mapped(std::size_t size) const { return size >= mmap_min; }
+
+public:
+    static constexpr std::size_t default_mmap_threshold = 256 * 1024;
+    static constexpr std::size_t default_huge_page_threshold = 4 * 1024 * 1024;
+
+    explicit mmap_charbuf_resource(
+        std::size_t mmap_threshold = default_mmap_threshold, 
+        std::size_t huge_page_threshold = default_huge_page_threshold
+    ): mmap_min(mmap_threshold), huge_min(huge_page_threshold) {}
+
+    std::size_t mmap_threshold() const { return mmap_min; }
+    std::size_t huge_page_threshold() const { return huge_min; }
+
+    void* reallocate(void* ptr, std::size_t size, std::size_t used, std::size_t new_size) override;
+    void deallocate(void* ptr, std::size_t size) override;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ansipp/caps.hpp>
+#include <ansipp/config.hpp>
+#include <ansipp/mouse.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief encodings selected for current session, consulted by escape emitters.
+ *
+ * Default session (without `config::detect_capabilities`) keeps encodings which work everywhere
+ * and doesn't change output of any emitter.
+ */
+struct session {
+    /**
+     * @brief capabilities the session was selected from (default constructed if detection was disabled)
+     */
+    terminal_caps caps;
+
+    /**
+     * @brief `attrs` RGB colors are emitted as 24-bit, otherwise they're mapped to nearest 256-color palette entry.
+     *  Detection turns it off only for terminals known to lack 24-bit colors (VT100 class DA1 reply)
+     */
+    bool truecolor = true;
+
+    /**
+     * @brief REP (`CSI n b`, repeat preceding character) is supported
+     */
+    bool rep = false;
+
+    /**
+     * @brief ECH (`CSI n X`, erase characters) is supported
+     */
+    bool ech = false;
+
+    /**
+     * @brief synchronized output mode (`?2026`) is supported
+     */
+    bool synchronized_output = false;
+
+    /**
+     * @brief mouse encoding used by `init()`
+     */
+    enum mouse_encoding mouse_encoding = MOUSE_UTF8;
+
+    /**
+     * @brief selects the most compact encodings supported by terminal,
+     *  encodings not confirmed by `caps` fall back to `cfg` (or to default session)
+     */
+    static session select(const terminal_caps& caps, const config& cfg = {});
+};
+
+/**
+ * @brief returns current session, set by `init()` or `set_session()`
+ */
+const session& current_session();
+
+/**
+ * @brief replaces current session, it's not thread-safe: call it before rendering starts
+ */
+void set_session(const session& s);
+
+}
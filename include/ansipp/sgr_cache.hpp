@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include <ansipp/attrs.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief bounded cache of pre-formatted SGR escapes keyed by `packed_attrs`.
+ *
+ * Open addressing table split into sets of `ways` slots, key hash selects set and lookup probes only its slots,
+ * so both hit and miss cost a few key compares. Miss formats escape into free slot of the set
+ * or evicts the least recently used one. Repeated styles (gradients, syntax highlighting, cell attributes)
+ * cost a probe and a small `memcpy` instead of formatting.
+ *
+ * Escapes depend on `session::truecolor`, cache is cleared when it changes.
+ *
+ * ```
+ * sgr_cache cache;
+ * out << cache.get(packed_attrs().fg(pos_to_rgb(v))) << ch;
+ * ```
+ */
+class sgr_cache {
+public:
+    static constexpr std::size_t ways = 4;
+
+    /**
+     * @brief length of the longest escape written by `packed_attrs`: `ESC[0;1;2;3;4;5;6;7;8;9;38;2;255;255;255;48;2;255;255;255m`
+     */
+    static constexpr std::size_t max_escape_size = 56;
+
+    /**
+     * @brief cached escape, `write_to` copies whole slot with fixed size `memcpy` (no length dependent branches)
+     */
+    struct escape {
+        const char* bytes;
+        std::size_t size;
+
+        static constexpr std::size_t max_size() { return max_escape_size; }
+        char* write_to(char* ptr) const { std::memcpy(ptr, bytes, max_escape_size); return ptr + size; }
+        std::string_view view() const { return std::string_view(bytes, size); }
+        operator std::string_view() const { return view(); }
+    };
+
+private:
+    struct entry {
+        std::uint64_t key;
+        std::uint64_t last_use;
+        unsigned char size; // `0` - free slot
+        char bytes[max_escape_size];
+    };
+
+    std::vector<entry> slots;
+    std::size_t set_mask;
+    std::uint64_t tick = 0;
+    std::uint64_t hit_count = 0;
+    std::uint64_t miss_count = 0;
+    std::uint64_t eviction_count = 0;
+    bool truecolor;
+
+    entry& miss(entry* set, packed_attrs a);
+
+public:
+    /**
+     * @param capacity maximum amount of cached escapes, rounded up to power of 2 (from `ways` to `ways * 2^24`)
+     */
+    explicit sgr_cache(std::size_t capacity = 1024);
+
+    /**
+     * @brief returns escape for `a`, valid until next `get` or `clear`
+     */
+    escape get(packed_attrs a) {
+        if (current_session().truecolor != truecolor) [[unlikely]] clear();
+        // high bits of fibonacci hash are the best mixed ones
+        entry* set = slots.data() + ((a.key * 0x9e3779b97f4a7c15ull) >> 40 & set_mask) * ways;
+        for (std::size_t i = 0; i < ways; ++i) {
+            entry& e = set[i];
+            if (e.key == a.key && e.size != 0) {
+                e.last_use = ++tick;
+                ++hit_count;
+                return escape { e.bytes, e.size };
+            }
+        }
+        const entry& e = miss(set, a);
+        return escape { e.bytes, e.size };
+    }
+
+    void clear();
+
+    std::size_t capacity() const { return slots.size(); }
+
+    /**
+     * @brief amount of cached escapes
+     */
+    std::size_t size() const;
+
+    std::uint64_t hits() const { return hit_count; }
+    std::uint64_t misses() const { return miss_count; }
+    std::uint64_t evictions() const { return eviction_count; }
+};
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <thread>
+#include <string_view>
+
+#include <ansipp/charbuf.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief thread-safe `stdout` sink for rendering from multiple threads.
+ *
+ * Each producer thread formats into its own `local()` buffer and calls `submit()` when segment is complete.
+ * Segments are passed through lock-free MPSC queue to single writer thread,
+ * which flushes everything queued so far with batched `writev` calls.
+ *
+ * Guarantees:
+ * - segment is written as a whole, escapes of different segments never interleave
+ * - segments submitted by same thread are written in submission order
+ * - producers never block on terminal I/O (`submit()` costs one allocation and one `memcpy`)
+ *
+ * Failed writes drop their segments, the first failure is kept (`error()`, `flush()`) so lost output is detectable.
+ */
+class output_sink {
+public:
+    struct segment {
+        segment* next;
+        std::size_t size;
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+private:
+    std::atomic<segment*> head = nullptr;
+    std::atomic<std::uint64_t> submitted = 0;
+    std::atomic<std::uint64_t> written = 0;
+    std::atomic<int> error_value = 0; // system error of the first failed write, `0` - none
+    segment stop_marker = { nullptr, 0 }; // pushed by destructor, writer stops after segments queued before it
+    std::thread writer;
+
+    void push(segment* s);
+    void run();
+
+public:
+    output_sink();
+    output_sink(const output_sink&) = delete;
+    output_sink& operator=(const output_sink&) = delete;
+
+    /**
+     * @brief writes all pending segments and stops writer thread
+     */
+    ~output_sink();
+
+    /**
+     * @brief returns calling thread buffer, it's shared by all sinks and never touched by writer thread
+     */
+    static charbuf& local();
+
+    /**
+     * @brief queues copy of specified data as single segment
+     * @param data segment data, empty segments are ignored
+     */
+    void submit(std::string_view data);
+
+    /**
+     * @brief queues content of specified buffer as single segment and resets buffer
+     * @param buf buffer to submit
+     */
+    void submit(charbuf& buf) { submit(buf.flush()); }
+
+    /**
+     * @brief queues content of calling thread `local()` buffer
+     */
+    void submit() { submit(local()); }
+
+    /**
+     * @brief blocks until all segments submitted before this call are written (or dropped by failed write)
+     * @return `error()` after these segments were processed
+     */
+    std::error_code flush();
+
+    /**
+     * @brief error of the first failed write (i.e. `EPIPE`), it's sticky: output is lost since then
+     */
+    std::error_code error() const { return std::error_code(error_value.load(std::memory_order_acquire), std::system_category()); }
+
+};
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <ios>
+
+#include <ansipp/static_charbuf.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief bulk `stdout` output backend which can avoid copying into kernel when `stdout` is a pipe (Linux only).
+ *
+ * Output is formatted directly into pages of a double-mapped ring buffer (`buffer()`),
+ * with `vmsplice` enabled `flush()` passes these pages to pipe by reference instead of copying them with `write`.
+ * Ring holds window plus pipe capacity and pages are reused once pipe could have been drained,
+ * double mapping makes every window contiguous, even if it wraps around ring end.
+ *
+ * `vmsplice` is opt-in because reused pages are correct only when reader copies data out of pipe with `read`
+ * (`less`, `grep`, shell scripts) and doesn't enlarge pipe afterwards. If reader moves pages further with
+ * `splice`/`tee` (`pv`, splice based relays) or raises pipe capacity (`F_SETPIPE_SZ`, as `pv` does),
+ * references outlive pipe and ring overwrites data which isn't delivered yet.
+ * With `vmsplice` enabled pipe capacity of reader is raised to window size when it's smaller
+ * (it's never shrunk, limited by /proc/sys/fs/pipe-max-size).
+ *
+ * Falls back to plain heap buffer and `write` when `vmsplice` isn't enabled, `stdout` isn't a pipe or `vmsplice`
+ * isn't available, so it can be used unconditionally (i.e. `app | less -R` is spliced, `app > file` and terminal are written).
+ *
+ * ```
+ * splice_output out(256 * 1024, true); // reader is known to `read` its input
+ * for (const auto& line: trace) {
+ *     if (out.buffer().available() < 256) out.flush();
+ *     out.buffer() << attrs().fg(line.color) << line.text << '\n';
+ * }
+ * out.flush();
+ * ```
+ */
+class splice_output {
+    char* ring = nullptr;
+    std::size_t ring_size = 0;
+    std::size_t window = 0;
+    std::size_t head = 0;
+    bool spliced = false;
+    fixed_charbuf buf;
+
+    bool init_ring();
+    void release_ring();
+    void next_window();
+
+public:
+    /**
+     * @param window_size maximal amount of bytes which can be buffered between `flush()` calls
+     * @param use_vmsplice pass pages to pipe with `vmsplice`, only safe for readers which `read` pipe (see above)
+     */
+    explicit splice_output(std::size_t window_size = 256 * 1024, bool use_vmsplice = false);
+    splice_output(const splice_output&) = delete;
+    splice_output& operator=(const splice_output&) = delete;
+
+    /**
+     * @brief flushes remaining data
+     */
+    ~splice_output();
+
+    /**
+     * @brief whether output goes through `vmsplice`
+     */
+    bool is_spliced() const { return spliced; }
+
+    /**
+     * @brief buffer to format output into, writes which don't fit are dropped (see `fixed_charbuf::overflow()`)
+     */
+    fixed_charbuf& buffer() { return buf; }
+
+    /**
+     * @brief passes buffered data to `stdout`
+     * @return amount of bytes written or `-1` in case of error
+     */
+    std::streamsize flush();
+
+};
+
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <concepts>
+#include <type_traits> // std::integral_constant
+
+#include <ansipp/integral.hpp>
+#include <ansipp/charbuf.hpp>
+#include <ansipp/io.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief `charbuf` counterpart which never allocates, formats into fixed external memory.
+ *
+ * Has the same `operator<<` surface as `charbuf`, so all escapes can be written into it.
+ * Each written item is either written completely or not written at all:
+ * first item which doesn't fit sets `overflow()` flag and all subsequent writes are ignored
+ * (until `reset()`), so buffer always contains complete prefix of written items and never partial escape.
+ *
+ * Safe to use in signal handlers and latency critical (real-time) threads.
+ * 
+ * `Self` is the most derived type (CRTP), so escape `operator<<` templates return it unchanged.
+ *
+ * @see fixed_charbuf
+ * @see static_charbuf
+ */
+template <typename Self>
+class fixed_charbuf_base {
+
+    char* b;
+    char* e;
+    char* p;
+    bool overflowed = false;
+
+    Self& self() { return static_cast<Self&>(*this); }
+
+    template <std::integral T>
+    Self& write_padded(const integral_format<T>& v) {
+        if (char* d = reserve(v.size())) v.write_to(d);
+        return self();
+    }
+
+protected:
+    void bind(char* buf, std::size_t size) { b = p = buf; e = buf + size; overflowed = false; }
+
+public:
+    fixed_charbuf_base(char* buf, std::size_t size): b(buf), e(buf + size), p(buf) {}
+    fixed_charbuf_base(const fixed_charbuf_base&) = delete;
+    fixed_charbuf_base& operator=(const fixed_charbuf_base&) = delete;
+
+    /**
+     * @brief reserves specified amount of bytes
+     * @return pointer to reserved bytes or `nullptr` if buffer doesn't have enough space (or already overflowed)
+     */
+    char* reserve(std::size_t size) {
+        if (overflowed || size > static_cast<std::size_t>(e - p)) [[unlikely]] {
+            overflowed = true;
+            return nullptr;
+        }
+        char* r = p;
+        p += size;
+        return r;
+    }
+
+    Self& reset() { p = b; overflowed = false; return self(); }
+    char* begin() { return b; }
+    const char* begin() const { return b; }
+    char* end() { return e; }
+    const char* end() const { return e; }
+    char* data() { return b; }
+    const char* data() const { return b; }
+    std::size_t capacity() const { return e - b; }
+    std::size_t size() const { return p - b; }
+    std::size_t available() const { return e - p; }
+
+    /**
+     * @brief whether any write was dropped since last `reset()`
+     */
+    bool overflow() const { return overflowed; }
+
+    /**
+     * @brief escapes without compile-time `max_size()` are written near the end of buffer only if their bound fits this scratch size
+     */
+    static constexpr std::size_t dynamic_scratch_size = 256;
+
+    std::string_view view() const { return std::string_view(b, p); }
+    std::string_view flush() { std::string_view v = view(); reset(); return v; }
+    std::string str() const { return std::string(b, p); }
+
+    void push_back(char ch) { if (char* d = reserve(1)) *d = ch; }
+
+    Self& put(const void* data, std::size_t size) { if (char* d = reserve(size)) std::memcpy(d, data, size); return self(); }
+    Self& put(char ch) { push_back(ch); return self(); }
+    Self& put(char ch, std::size_t count) { if (char* d = reserve(count)) std::memset(d, ch, count); return self(); }
+
+    template <typename T>
+    Self& operator<<(const T& v) && { return self() << v; }
+
+    Self& operator<<(char c) { return put(c); }
+    Self& operator<<(bool v) { return put(v ? '1' : '0'); }
+    Self& operator<<(const char* sv) { return put(sv, std::strlen(sv)); }
+    Self& operator<<(std::string_view sv) { return put(sv.data(), sv.size()); }
+
+    template <std::unsigned_integral T>
+    Self& operator<<(const integral_format<T>& v) {
+        if (!v.plain()) return write_padded(v);
+        unsigned int width = v.width == 0 ? ulen(v.value, v.base) : v.width;
+        if (char* d = reserve(width)) uchars(d, width, v.value, v.base, v.upper);
+        return self();
+    }
+
+    template <std::unsigned_integral T>
+    Self& operator<<(T v) {
+        unsigned int w = ulen10(v);
+        if (char* d = reserve(w)) uchars(d, w, v, 10, false);
+        return self();
+    }
+
+    template <sized_escape T>
+    Self& operator<<(const T& e) {
+        const std::size_t max = e.max_size();
+        if (!overflowed && max <= available()) [[likely]] {
+            p = e.write_to(p);
+            return self();
+        }
+        // near the end: real size is known only after formatting, escape is formatted into stack scratch buffer
+        // sized by compile-time bound if escape has one, otherwise by `dynamic_scratch_size`
+        if (overflowed) return self();
+        if constexpr (requires { std::integral_constant<std::size_t, T::max_size()>{}; }) {
+            char tmp[T::max_size()];
+            return put(tmp, e.write_to(tmp) - tmp);
+        } else {
+            char tmp[dynamic_scratch_size];
+            if (max <= sizeof(tmp)) return put(tmp, e.write_to(tmp) - tmp);
+            overflowed = true;
+            return self();
+        }
+    }
+
+    template <std::signed_integral T>
+    Self& operator<<(integral_format<T> v) {
+        if (!v.plain()) return write_padded(v);
+        unsigned int width = v.width == 0 ? ilen(v.value, v.base) : v.width;
+        if (char* d = reserve(width)) ichars(d, width, v.value, v.base, v.upper);
+        return self();
+    }
+
+    template <std::signed_integral T>
+    Self& operator<<(T v) {
+        unsigned int w = ilen(v, 10);
+        if (char* d = reserve(w)) ichars(d, w, v, 10, false);
+        return self();
+    }
+
+    template <std::floating_point T>
+    Self& operator<<(floating_format<T> v) {
+        if (overflowed) return self();
+        const std::to_chars_result r = v.precision < 0
+            ? std::to_chars(p, e, v.value, v.format)
+            : std::to_chars(p, e, v.value, v.format, v.precision);
+        if (r.ec == std::errc::value_too_large) overflowed = true; else p = r.ptr;
+        return self();
+    }
+
+    template <std::floating_point T>
+    Self& operator<<(fixed_format<T> v) {
+        char tmp[fixed_chars_max];
+        if (const char* r = fixed_chars(tmp, v)) [[likely]] return put(tmp, r - tmp);
+        return *this << floating_format(v.value, std::chars_format::fixed, static_cast<int>(v.precision));
+    }
+
+    template <std::floating_point T>
+    Self& operator<<(T v) { return *this << floating_format(v); }
+
+    Self& operator<<(fill f) { return put(f.ch, f.count); }
+
+    Self& operator<<(void(*fn)(Self&)) { fn(self()); return self(); }
+
+    static void reset(Self& b) { b.reset(); }
+    static void to_stdout(Self& b) { stdout_write(b.flush()); }
+    static void to_stderr(Self& b) { stderr_write(b.flush()); }
+
+};
+
+/**
+ * @brief `fixed_charbuf_base` over external memory
+ */
+class fixed_charbuf: public fixed_charbuf_base<fixed_charbuf> {
+public:
+    fixed_charbuf(char* buf, std::size_t size): fixed_charbuf_base(buf, size) {}
+
+    /**
+     * @brief rebinds buffer to other memory, buffer is reset
+     */
+    fixed_charbuf& assign(char* buf, std::size_t size) { bind(buf, size); return *this; }
+};
+
+/**
+ * @brief stack-backed `fixed_charbuf_base` with `N` bytes of inline storage.
+ *
+ * ```
+ * void on_signal(int) {
+ *     static_charbuf<64> out;
+ *     out << cursor_visibility.on() << alternate_buffer.off() << static_charbuf<64>::to_stdout;
+ * }
+ * ```
+ */
+template <std::size_t N>
+class static_charbuf: public fixed_charbuf_base<static_charbuf<N>> {
+    char storage[N];
+public:
+    static_charbuf(): fixed_charbuf_base<static_charbuf<N>>(storage, N) {}
+};
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// instrumentation counters, disabled by default (counting code is compiled out)
+// 0 - disabled
+// 1 - I/O syscalls and bytes, `charbuf` reallocations
+// must be the same for library and all code using it (CMake option `ANSIPP_STATS` sets it for both)
+#ifndef ANSIPP_STATS
+#define ANSIPP_STATS 0
+#endif
+
+namespace ansipp {
+
+/**
+ * @brief snapshot of instrumentation counters (all zeros if `ANSIPP_STATS` is disabled)
+ */
+struct stats {
+    /**
+     * @brief `write`/`writev`/`vmsplice` syscalls (or `WriteFile` calls) for `stdout` and `stderr`
+     */
+    std::uint64_t write_calls = 0;
+    std::uint64_t write_bytes = 0;
+
+    /**
+     * @brief `read` syscalls (or `ReadFile` calls) for `stdin`
+     */
+    std::uint64_t read_calls = 0;
+    std::uint64_t read_bytes = 0;
+
+    /**
+     * @brief `stdin_read_ready` waits and how many of them reported available input
+     */
+    std::uint64_t poll_calls = 0;
+    std::uint64_t poll_wakeups = 0;
+
+    /**
+     * @brief `charbuf` storage reallocations and total size of allocated blocks
+     */
+    std::uint64_t charbuf_reallocs = 0;
+    std::uint64_t charbuf_realloc_bytes = 0;
+
+    stats operator-(const stats& o) const {
+        return stats {
+            write_calls - o.write_calls, write_bytes - o.write_bytes,
+            read_calls - o.read_calls, read_bytes - o.read_bytes,
+            poll_calls - o.poll_calls, poll_wakeups - o.poll_wakeups,
+            charbuf_reallocs - o.charbuf_reallocs, charbuf_realloc_bytes - o.charbuf_realloc_bytes
+        };
+    }
+};
+
+/**
+ * @brief live counters, updated with relaxed atomics from any thread
+ */
+struct stats_counters {
+    std::atomic<std::uint64_t> write_calls = 0;
+    std::atomic<std::uint64_t> write_bytes = 0;
+    std::atomic<std::uint64_t> read_calls = 0;
+    std::atomic<std::uint64_t> read_bytes = 0;
+    std::atomic<std::uint64_t> poll_calls = 0;
+    std::atomic<std::uint64_t> poll_wakeups = 0;
+    std::atomic<std::uint64_t> charbuf_reallocs = 0;
+    std::atomic<std::uint64_t> charbuf_realloc_bytes = 0;
+};
+
+stats_counters& stats_storage();
+
+/**
+ * @brief returns current values of counters, values are read independently (not atomic snapshot)
+ */
+stats get_stats();
+
+void reset_stats();
+
+}
+
+#if ANSIPP_STATS
+#   define ANSIPP_STATS_ADD(counter, value) \
+        ::ansipp::stats_storage().counter.fetch_add(static_cast<std::uint64_t>(value), std::memory_order_relaxed)
+#else
+#   define ANSIPP_STATS_ADD(counter, value) ((void)0)
+#endif
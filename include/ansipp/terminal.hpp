@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstring>
 #include <ostream>
 #include <ansipp/esc.hpp>
 #include <ansipp/vec.hpp>
+#include <ansipp/cursor.hpp>
+#include <ansipp/session.hpp>
 
 namespace ansipp {
 
@@ -13,8 +16,8 @@ bool is_terminal();
 
 vec get_terminal_size();
 
-const std::string hard_reset = esc + 'c'; 
-const std::string soft_reset = csi + "!p";
+constexpr std::string_view hard_reset = "\x1b" "c";
+constexpr std::string_view soft_reset = "\x1b[" "!p";
 
 constexpr decset_mode line_wrap = 7;
 constexpr decset_mode alternate_buffer = 1049;
@@ -35,12 +38,145 @@ struct erase {
     erase_target target;
     erase_mode mode;
     erase(erase_target target, erase_mode mode): target(target), mode(mode) {}
+
+    static constexpr std::size_t max_size() { return csi.size() + 2; }
+    char* write_to(char* ptr) const {
+        ptr = write_str(ptr, csi);
+        if (mode != TO_END) *ptr++ = static_cast<char>(mode);
+        *ptr = static_cast<char>(target);
+        return ptr + 1;
+    }
+};
+
+/**
+ * @brief REP: repeats preceding graphic character `count` times, the character must be written right before it
+ */
+struct repeat_char {
+    unsigned int count;
+    explicit repeat_char(unsigned int count): count(count) {}
+
+    static constexpr std::size_t max_size() { return csi.size() + small_uint::max_size() + 1; }
+    char* write_to(char* ptr) const {
+        ptr = write_str(ptr, csi);
+        if (count > 1) ptr = small_uint(count).write_to(ptr);
+        *ptr = 'b';
+        return ptr + 1;
+    }
+};
+
+/**
+ * @brief ECH: erases `count` characters starting at cursor (cells get current background color), cursor doesn't move
+ */
+struct erase_chars {
+    unsigned int count;
+    explicit erase_chars(unsigned int count): count(count) {}
+
+    static constexpr std::size_t max_size() { return csi.size() + small_uint::max_size() + 1; }
+    char* write_to(char* ptr) const {
+        ptr = write_str(ptr, csi);
+        if (count > 1) ptr = small_uint(count).write_to(ptr);
+        *ptr = 'X';
+        return ptr + 1;
+    }
+};
+
+/**
+ * @brief encoding of run of same characters, chosen by size and current session (`session::rep`, `session::ech`)
+ */
+struct cell_run {
+    enum kind { PLAIN, REP, ECH };
+    kind k = PLAIN;
+    std::size_t size = 0;
+
+    static std::size_t csi_size(unsigned int n) { return csi.size() + (n > 1 ? ulen10(n) : 0) + 1; }
+
+    // writes exactly `csi_size(n)` bytes (`small_uint` may touch 4 bytes past short numbers, runs have exact sizes)
+    static char* write_csi(char* ptr, unsigned int n, char final) {
+        ptr = write_str(ptr, csi);
+        if (n > 1) {
+            const unsigned int len = ulen10(n);
+            uchars(ptr, len, n, 10, false);
+            ptr += len;
+        }
+        *ptr = final;
+        return ptr + 1;
+    }
+
+    /**
+     * @param row_continues more cells of the same row are written after the run (ECH is allowed only then)
+     */
+    static cell_run select(char ch, unsigned int count, bool row_continues, const session& s = current_session()) {
+        cell_run r { PLAIN, count };
+        if (count <= 4) return r; // both REP and ECH take at least 4 bytes
+        // REP repeats only graphic characters
+        if (s.rep && ch >= 0x20 && ch < 0x7f) {
+            if (const std::size_t n = 1 + csi_size(count - 1); n < r.size) r = { REP, n };
+        }
+        // ECH doesn't move cursor, so it's followed by `CURSOR_RIGHT`, which stops at the right margin
+        // instead of setting pending wrap like printed spaces do
+        if (s.ech && row_continues && ch == ' ') {
+            if (const std::size_t n = 2 * csi_size(count); n < r.size) r = { ECH, n };
+        }
+        return r;
+    }
+
+    char* write_to(char* ptr, char ch, unsigned int count) const {
+        switch (k) {
+        case REP:
+            *ptr++ = ch;
+            return write_csi(ptr, count - 1, 'b');
+        case ECH:
+            return write_csi(write_csi(ptr, count, 'X'), count, 'C');
+        default:
+            std::memset(ptr, ch, count);
+            return ptr + count;
+        }
+    }
+};
+
+/**
+ * @brief writes `count` same characters (i.e. padding or clearing of row part) in the most compact form supported by terminal:
+ *  REP (`repeat_char`) for any printable ASCII character, ECH (`erase_chars`) followed by cursor movement for spaces.
+ *
+ * Unlike `fill` it's terminal output only: run must fit in current row,
+ * and cells cleared with ECH get only background color of current attrs (i.e. no underline or inverse).
+ *
+ * ECH is used only when `row_continues` is set, i.e. caller writes more cells of the same row after the run.
+ * Run which ends at the right margin must not use it: cursor movement stops at the last column and clears
+ * pending wrap, so the next character would overwrite the last cell instead of wrapping to the next row.
+ */
+struct fill_cells {
+    char ch;
+    unsigned int count;
+    bool row_continues;
+    fill_cells(char ch, unsigned int count, bool row_continues = false): ch(ch), count(count), row_continues(row_continues) {}
+
+    std::size_t max_size() const { return cell_run::select(ch, count, row_continues).size; }
+    char* write_to(char* ptr) const { return cell_run::select(ch, count, row_continues).write_to(ptr, ch, count); }
+};
+
+/**
+ * @brief writes row text (must fit in current row), runs of same characters are compressed like `fill_cells`.
+ *  The last run may end at the right margin, so it's never written with ECH
+ */
+struct text_runs {
+    std::string_view text;
+    explicit text_runs(std::string_view text): text(text) {}
+
+    // compressed runs are never longer than plain ones
+    std::size_t max_size() const { return text.size(); }
+    char* write_to(char* ptr) const {
+        const session& s = current_session();
+        if (!s.rep && !s.ech) return write_str(ptr, text);
+        for (std::size_t i = 0; i < text.size();) {
+            std::size_t j = i + 1;
+            while (j < text.size() && text[j] == text[i]) ++j;
+            const unsigned int count = static_cast<unsigned int>(j - i);
+            ptr = cell_run::select(text[i], count, j < text.size(), s).write_to(ptr, text[i], count);
+            i = j;
+        }
+        return ptr;
+    }
 };
-template <typename Stream>
-Stream& operator<<(Stream& s, erase esc) {
-    s << csi;
-    if (esc.mode != TO_END) s << static_cast<char>(esc.mode);
-    return s << static_cast<char>(esc.target);
-}
 
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <ansipp/io.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief input-to-output latency distribution, log2 buckets of microseconds
+ */
+struct latency_histogram {
+    static constexpr std::size_t bucket_count = 32;
+
+    /**
+     * @brief `buckets[i]` counts latencies in `[2^(i-1), 2^i)` microseconds (`buckets[0]` - below 1us)
+     */
+    std::array<std::uint64_t, bucket_count> buckets = {};
+    std::uint64_t count = 0;
+    std::int64_t total_ns = 0;
+    std::int64_t max_ns = 0;
+
+    void add(std::int64_t ns);
+
+    double mean_ns() const { return count == 0 ? 0 : static_cast<double>(total_ns) / static_cast<double>(count); }
+
+    /**
+     * @brief upper bound of bucket containing `p`-th percentile in nanoseconds, i.e. `percentile_ns(0.99)`
+     */
+    std::int64_t percentile_ns(double p) const;
+};
+
+/**
+ * @brief traces latency between terminal input and output which answers it.
+ *
+ * Installed as I/O tap (`set_io_tap(io_tap*)`), every input chunk read by `stdin_read` and every `stdout_write`
+ * is timestamped with monotonic clock. Inputs read since previous output are correlated with the next output:
+ * the frame flushed after keypress is the one which shows its result, so the first write after input
+ * ends its latency.
+ *
+ * Example:
+ * ```
+ * latency_tracer tracer;
+ * set_io_tap(&tracer);
+ * ...
+ * set_io_tap(nullptr);
+ * tracer.histogram().percentile_ns(0.99);
+ * tracer.write_chrome_trace(file); // open in chrome://tracing or Perfetto
+ * ```
+ */
+class latency_tracer: public io_tap {
+public:
+    struct event {
+        io_direction dir;
+        std::int64_t ts_ns;
+        std::uint64_t bytes;
+
+        /**
+         * @brief output: timestamp of the oldest input answered by this output, `-1` if it isn't answer to input
+         */
+        std::int64_t input_ts_ns;
+    };
+
+private:
+    mutable std::mutex mutex;
+    std::vector<event> events_ring;
+    std::size_t max_events;
+    std::size_t next = 0;
+    std::uint64_t dropped = 0;
+    std::vector<std::int64_t> pending_inputs;
+    latency_histogram hist;
+    io_tap* forward;
+
+public:
+    /**
+     * @param capacity maximum amount of stored events, the oldest events are overwritten (histogram keeps all)
+     * @param forward another tap (i.e. `asciicast_recorder`) which receives all I/O as well
+     */
+    explicit latency_tracer(std::size_t capacity = 64 * 1024, io_tap* forward = nullptr);
+
+    void on_io(io_direction dir, std::string_view data) override;
+    void on_io_parts(io_direction dir, std::span<const std::string_view> parts) override;
+
+    /**
+     * @brief records event with explicit timestamp (`on_io` uses `steady_clock`)
+     */
+    void record(io_direction dir, std::size_t bytes, std::int64_t ts_ns);
+
+    /**
+     * @brief stored events in chronological order
+     */
+    std::vector<event> events() const;
+
+    latency_histogram histogram() const;
+
+    /**
+     * @brief events overwritten because of capacity limit
+     */
+    std::uint64_t dropped_events() const;
+
+    void clear();
+
+    /**
+     * @brief writes stored events as Chrome trace event JSON:
+     *  instant events for input and output, complete event `latency` for each answered input
+     */
+    void write_chrome_trace(std::FILE* f) const;
+};
+
+}
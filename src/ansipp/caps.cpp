@@ -0,0 +1,311 @@
+#include <ansipp/caps.hpp>
+#include <ansipp/io.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#   include <process.h>
+#else
+#   include <unistd.h>
+#endif
+
+namespace ansipp {
+
+namespace {
+
+struct csi_reply {
+    char prefix;        // '?', '>' or 0
+    int params[8];
+    std::size_t count;
+    std::string_view intermediate;
+    char final;
+};
+
+// parses CSI sequence after "\x1b[", returns length of parsed part or 0 if sequence is incomplete
+std::size_t parse_csi(std::string_view v, csi_reply& r) {
+    std::size_t i = 0;
+    r.prefix = i < v.size() && (v[i] == '?' || v[i] == '>') ? v[i++] : 0;
+    r.count = 0;
+    int cur = -1;
+    for (; i < v.size() && v[i] >= '0' && v[i] <= ';'; ++i) {
+        if (v[i] == ';') {
+            if (r.count < std::size(r.params)) r.params[r.count++] = cur < 0 ? 0 : cur;
+            cur = -1;
+        } else if (v[i] <= '9') {
+            cur = (cur < 0 ? 0 : cur * 10) + (v[i] - '0');
+        }
+    }
+    if (cur >= 0 && r.count < std::size(r.params)) r.params[r.count++] = cur;
+    const std::size_t im = i;
+    for (; i < v.size() && v[i] >= 0x20 && v[i] <= 0x2f; ++i);
+    r.intermediate = v.substr(im, i - im);
+    if (i >= v.size() || v[i] < 0x40 || v[i] > 0x7e) return 0;
+    r.final = v[i];
+    return i + 1;
+}
+
+// DECRQM reply value: 1 - set, 2 - reset, 3 - permanently set, 0 and 4 - not supported
+bool decrqm_supported(int v) { return v >= 1 && v <= 3; }
+
+void apply_csi(const csi_reply& r, terminal_caps& caps, bool& done) {
+    if (r.prefix == '?' && r.final == 'y' && r.intermediate == "$" && r.count == 2) {
+        const bool supported = decrqm_supported(r.params[1]);
+        switch (r.params[0]) {
+            case 2026: caps.synchronized_output = supported; break;
+            case 1006: caps.mouse_sgr = supported; break;
+            case 2004: caps.bracketed_paste = supported; break;
+            case 1004: caps.focus_reporting = supported; break;
+        }
+    } else if (r.prefix == '>' && r.final == 'c' && r.intermediate.empty()) {
+        caps.da2_type = r.count > 0 ? r.params[0] : 0;
+        caps.da2_version = r.count > 1 ? r.params[1] : 0;
+    } else if (r.prefix == '?' && r.final == 'c' && r.intermediate.empty()) {
+        // first parameter is terminal class, attributes follow
+        caps.da1_class = r.count > 0 ? r.params[0] : 0;
+        for (std::size_t i = 1; i < r.count; ++i) if (r.params[i] == 4) caps.sixel = true;
+        caps.answered = true;
+        done = true;
+    }
+}
+
+bool env_equals(const char* name, std::string_view v) {
+    const char* e = std::getenv(name);
+    return e != nullptr && e == v;
+}
+
+std::string_view env(const char* name) {
+    const char* e = std::getenv(name);
+    return e != nullptr ? std::string_view(e) : std::string_view();
+}
+
+bool env_truecolor() {
+    return env_equals("COLORTERM", "truecolor") || env_equals("COLORTERM", "24bit");
+}
+
+// terminals which support 24-bit colors but don't always set `COLORTERM` (i.e. over ssh)
+bool version_truecolor(std::string_view version) {
+    constexpr std::string_view known[] = { "kitty", "WezTerm", "foot", "iTerm2", "ghostty", "XTerm", "Konsole", "contour" };
+    for (std::string_view k: known) if (version.starts_with(k)) return true;
+    return false;
+}
+
+// unique name of temporary file next to `path`: processes (and threads) saving concurrently never share it
+std::filesystem::path temp_path(const std::filesystem::path& path) {
+    static std::atomic<unsigned int> counter = 0;
+#ifdef _WIN32
+    const long pid = _getpid();
+#else
+    const long pid = static_cast<long>(getpid());
+#endif
+    return path.string() + ".tmp." + std::to_string(pid) + "." + std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+// keys and versions are stored in tab separated lines
+std::string sanitize(std::string_view v) {
+    std::string s(v);
+    for (char& c: s) if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+    return s;
+}
+
+enum caps_flag: unsigned int {
+    TRUECOLOR = 1 << 0,
+    SYNCHRONIZED_OUTPUT = 1 << 1,
+    MOUSE_SGR = 1 << 2,
+    BRACKETED_PASTE = 1 << 3,
+    FOCUS_REPORTING = 1 << 4,
+    SIXEL = 1 << 5
+};
+
+std::string_view next_field(std::string_view& line) {
+    const std::size_t p = line.find('\t');
+    std::string_view f = line.substr(0, p);
+    line.remove_prefix(p == std::string_view::npos ? line.size() : p + 1);
+    return f;
+}
+
+template <typename T>
+bool parse_field(std::string_view f, T& v) {
+    const auto [ptr, ec] = std::from_chars(f.data(), f.data() + f.size(), v);
+    return ec == std::errc() && ptr == f.data() + f.size();
+}
+
+}
+
+bool parse_caps_replies(std::string_view replies, terminal_caps& caps) {
+    bool done = false;
+    for (std::size_t p = replies.find('\x1b'); p != std::string_view::npos; p = replies.find('\x1b')) {
+        replies.remove_prefix(p + 1);
+        if (replies.starts_with('[')) {
+            csi_reply r;
+            const std::size_t n = parse_csi(replies.substr(1), r);
+            if (n == 0) continue;
+            apply_csi(r, caps, done);
+            replies.remove_prefix(n + 1);
+        } else if (replies.starts_with("P>|")) {
+            const std::size_t end = replies.find("\x1b\\");
+            if (end == std::string_view::npos) break;
+            caps.version = std::string(replies.substr(3, end - 3));
+            replies.remove_prefix(end);
+        }
+    }
+    if (version_truecolor(caps.version)) caps.truecolor = true;
+    return done;
+}
+
+std::string caps_cache_key() {
+    // emulator specific variables, for those which differ per window (ids, sockets) only presence is recorded
+    constexpr const char* version_vars[] = { "VTE_VERSION", "KONSOLE_VERSION", "XTERM_VERSION", "TERMINAL_EMULATOR" };
+    constexpr const char* presence_vars[] = { "KITTY_WINDOW_ID", "ALACRITTY_WINDOW_ID", "WEZTERM_PANE", "WT_SESSION" };
+    // multiplexers answer some queries themselves, they are part of key but don't identify emulator
+    constexpr const char* multiplexer_vars[] = { "TMUX", "STY", "ZELLIJ" };
+
+    std::string key(env("TERM"));
+    key += ';';
+    key += env("TERM_PROGRAM");
+    key += ';';
+    key += env("TERM_PROGRAM_VERSION");
+    bool identified = !env("TERM_PROGRAM").empty();
+    for (const char* name: version_vars) {
+        if (std::string_view v = env(name); !v.empty()) {
+            key.append(";").append(name).append("=").append(v);
+            identified = true;
+        }
+    }
+    for (const char* name: presence_vars) {
+        if (!env(name).empty()) {
+            key.append(";").append(name);
+            identified = true;
+        }
+    }
+    for (const char* name: multiplexer_vars) if (!env(name).empty()) key.append(";").append(name);
+    return identified ? sanitize(key) : std::string();
+}
+
+std::string caps_cache_path() {
+#ifdef _WIN32
+    if (std::string_view d = env("LOCALAPPDATA"); !d.empty()) return std::string(d) + "\\ansipp\\caps";
+#else
+    if (std::string_view d = env("XDG_CACHE_HOME"); !d.empty()) return std::string(d) + "/ansipp/caps";
+    if (std::string_view d = env("HOME"); !d.empty()) return std::string(d) + "/.cache/ansipp/caps";
+#endif
+    return {};
+}
+
+std::string serialize_caps(std::string_view key, const terminal_caps& caps) {
+    unsigned int flags = 0;
+    if (caps.truecolor) flags |= TRUECOLOR;
+    if (caps.synchronized_output) flags |= SYNCHRONIZED_OUTPUT;
+    if (caps.mouse_sgr) flags |= MOUSE_SGR;
+    if (caps.bracketed_paste) flags |= BRACKETED_PASTE;
+    if (caps.focus_reporting) flags |= FOCUS_REPORTING;
+    if (caps.sixel) flags |= SIXEL;
+
+    std::string line = sanitize(key);
+    for (int v: { static_cast<int>(flags), caps.da1_class, caps.da2_type, caps.da2_version }) {
+        line += '\t';
+        line += std::to_string(v);
+    }
+    line += '\t';
+    line += sanitize(caps.version);
+    return line;
+}
+
+bool deserialize_caps(std::string_view line, std::string_view key, terminal_caps& caps) {
+    if (next_field(line) != key) return false;
+    unsigned int flags;
+    terminal_caps c;
+    if (!parse_field(next_field(line), flags)) return false;
+    if (!parse_field(next_field(line), c.da1_class)) return false;
+    if (!parse_field(next_field(line), c.da2_type)) return false;
+    if (!parse_field(next_field(line), c.da2_version)) return false;
+    c.version = std::string(line);
+    c.truecolor = flags & TRUECOLOR;
+    c.synchronized_output = flags & SYNCHRONIZED_OUTPUT;
+    c.mouse_sgr = flags & MOUSE_SGR;
+    c.bracketed_paste = flags & BRACKETED_PASTE;
+    c.focus_reporting = flags & FOCUS_REPORTING;
+    c.sixel = flags & SIXEL;
+    c.answered = true; // only answered probes are cached
+    caps = std::move(c);
+    return true;
+}
+
+bool load_caps(const std::string& path, std::string_view key, terminal_caps& caps) {
+    std::ifstream in(path);
+    for (std::string line; std::getline(in, line);) {
+        if (deserialize_caps(line, key, caps)) return true;
+    }
+    return false;
+}
+
+bool save_caps(const std::string& path, std::string_view key, const terminal_caps& caps) {
+    const std::string k = sanitize(key);
+    std::vector<std::string> lines;
+    {
+        std::ifstream in(path);
+        for (std::string line; std::getline(in, line);) {
+            std::string_view v = line;
+            if (!line.empty() && next_field(v) != k) lines.push_back(std::move(line));
+        }
+    }
+    lines.push_back(serialize_caps(k, caps));
+
+    // write and rename, so concurrent readers never see partially written file
+    std::error_code ec;
+    const std::filesystem::path p(path);
+    if (p.has_parent_path()) std::filesystem::create_directories(p.parent_path(), ec);
+    const std::filesystem::path tmp = temp_path(p);
+    bool written;
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        for (const std::string& line: lines) out << line << '\n';
+        written = static_cast<bool>(out.flush());
+    }
+    if (written) std::filesystem::rename(tmp, p, ec);
+    if (!written || ec) std::filesystem::remove(tmp, ec);
+    return written && !ec;
+}
+
+terminal_caps probe_caps(int timeout) {
+    terminal_caps caps;
+    caps.truecolor = env_truecolor();
+    if (stdout_write(caps_query) != static_cast<std::streamsize>(caps_query.size())) return caps;
+
+    using clock = std::chrono::steady_clock;
+    const clock::time_point deadline = clock::now() + std::chrono::milliseconds(timeout);
+    std::string replies;
+    char buf[256];
+    for (;;) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now()).count();
+        if (left <= 0) break;
+        const std::streamsize r = stdin_read(buf, sizeof(buf), static_cast<int>(left));
+        if (r <= 0) break;
+        replies.append(buf, static_cast<std::size_t>(r));
+        // DA1 reply ends with 'c', cheap check before parsing whole input again
+        if (buf[r - 1] == 'c' && parse_caps_replies(replies, caps)) return caps;
+    }
+    parse_caps_replies(replies, caps);
+    return caps;
+}
+
+terminal_caps detect_caps(int timeout, const std::string& path) {
+    const std::string key = caps_cache_key();
+    const bool cached = !path.empty() && !key.empty();
+    terminal_caps caps;
+    if (cached && load_caps(path, key, caps)) {
+        caps.truecolor = caps.truecolor || env_truecolor();
+        return caps;
+    }
+    caps = probe_caps(timeout);
+    if (cached && caps.answered) save_caps(path, key, caps);
+    return caps;
+}
+
+}
@@ -0,0 +1,43 @@
+#include <ansipp/frame.hpp>
+#include <ansipp/io.hpp>
+
+namespace ansipp {
+
+const std::vector<std::string_view>& frame_builder::parts() {
+    iov.clear();
+    const char* b = buf.data();
+    std::size_t prev = 0;
+    for (const splice_point& s: splices) {
+        if (s.offset > prev) iov.emplace_back(b + prev, s.offset - prev);
+        iov.push_back(s.segment.view());
+        prev = s.offset;
+    }
+    if (buf.size() > prev) iov.emplace_back(b + prev, buf.size() - prev);
+    return iov;
+}
+
+std::string frame_builder::str() const {
+    std::string result;
+    result.reserve(size());
+    const std::string_view v = buf.view();
+    std::size_t prev = 0;
+    for (const splice_point& s: splices) {
+        result.append(v.substr(prev, s.offset - prev)).append(s.segment.view());
+        prev = s.offset;
+    }
+    return result.append(v.substr(prev));
+}
+
+void frame_builder::reset() {
+    buf.reset();
+    splices.clear();
+    spliced_bytes = 0;
+}
+
+std::streamsize frame_builder::flush() {
+    const std::streamsize w = stdout_write(std::span<const std::string_view>(parts()));
+    reset();
+    return w;
+}
+
+}
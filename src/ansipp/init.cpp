@@ -14,6 +14,9 @@
 #include <ansipp/cursor.hpp>
 #include <ansipp/attrs.hpp>
 #include <ansipp/mouse.hpp>
+#include <ansipp/resource.hpp>
+#include <ansipp/caps.hpp>
+#include <ansipp/session.hpp>
 
 #include "restore.hpp"
 
@@ -113,7 +116,7 @@ void atexit_restore(std::error_code& ec) {
 void configure_mouse(const config& cfg, charbuf& init_esc, charbuf& restore_esc) {
     const decset_mode* mode = get_mouse_mode_decset(cfg.mouse_mode);
     if (mode == nullptr) return;
-    const decset_mode* enc = get_mouse_encoding_decset(cfg.mouse_encoding);
+    const decset_mode* enc = get_mouse_encoding_decset(current_session().mouse_encoding);
     if (enc != nullptr) init_esc << enc->on();
     init_esc << mode->on();
     restore_esc << mode->off();
@@ -147,8 +150,14 @@ void init_non_restorable(std::error_code& ec, const config& cfg) {
     if (cfg.enable_utf8 && (enable_utf8(ec), ec)) { return; }
 }
 
+void configure_session(const config& cfg) {
+    // replies are read after echo was disabled by configure_mode()
+    set_session(session::select(cfg.detect_capabilities ? detect_caps(cfg.detect_timeout) : terminal_caps {}, cfg));
+}
+
 void init_restorable(std::error_code& ec, const config& cfg) {
     if (configure_mode(ec, cfg), ec) return;
+    configure_session(cfg);
     if (configure_escapes(cfg, ec), ec) return;
     if (cfg.enable_exit_restore && (atexit_restore(ec), ec)) return;
     if (cfg.enable_signal_restore && (enable_signal_restore(ec), ec)) return;
@@ -169,7 +178,9 @@ void init(std::error_code& ec, const config& cfg) {
 
 void init_or_exit(const config &cfg) {
     if (std::error_code ec; init(ec, cfg), ec) { 
-        stderr_write((charbuf() << "can't init: " << ec.message()).view());
+        char storage[256];
+        arena_charbuf_resource mem(storage, sizeof(storage));
+        stderr_write((charbuf(mem) << "can't init: " << ec.message()).view());
         std::exit(EXIT_FAILURE);
     }
 }
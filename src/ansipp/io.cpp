@@ -1,14 +1,39 @@
 #include <ansipp/io.hpp>
+#include <ansipp/stats.hpp>
+
+#include <algorithm>
+#include <atomic>
 
 #ifdef _WIN32
 #   include <windows.h>
 #else
 #   include <unistd.h>
 #   include <poll.h>
+#   include <sys/uio.h>
+#   include <errno.h>
 #endif
 
+#include "io.hpp"
+
 namespace ansipp {
 
+namespace {
+std::atomic<io_tap*> active_tap = nullptr;
+}
+
+void set_io_tap(io_tap* tap) { active_tap.store(tap, std::memory_order_release); }
+
+void notify_tap(io_direction dir, const void* buf, std::streamsize sz) {
+    if (sz <= 0) return;
+    if (io_tap* tap = active_tap.load(std::memory_order_acquire)) [[unlikely]] {
+        tap->on_io(dir, std::string_view(static_cast<const char*>(buf), static_cast<std::size_t>(sz)));
+    }
+}
+
+void notify_tap(io_direction dir, std::span<const std::string_view> parts) {
+    if (io_tap* tap = active_tap.load(std::memory_order_acquire)) [[unlikely]] tap->on_io_parts(dir, parts);
+}
+
 std::streamsize fd_write(bool err, const void* buf, std::size_t sz) {
     if (sz == 0) return 0; // fast return to avoid syscall
 #ifdef _WIN32
@@ -17,37 +42,104 @@ std::streamsize fd_write(bool err, const void* buf, std::size_t sz) {
     if (out == INVALID_HANDLE_VALUE) return -1;
     
     DWORD result;
-    return WriteFile(out, buf, static_cast<DWORD>(sz), &result, nullptr) ? result : -1;
+    const std::streamsize w = WriteFile(out, buf, static_cast<DWORD>(sz), &result, nullptr) ? result : -1;
 #else
     constexpr int fds[] = { STDOUT_FILENO, STDERR_FILENO }; 
-    return write(fds[err], buf, sz);
+    const std::streamsize w = write(fds[err], buf, sz);
 #endif
+    ANSIPP_STATS_ADD(write_calls, 1);
+    if (w > 0) ANSIPP_STATS_ADD(write_bytes, w);
+    return w;
 }
 
 std::streamsize stdout_write(const void* buf, std::size_t sz) {
-    return fd_write(false, buf, sz);
+    const std::streamsize w = fd_write(false, buf, sz);
+    notify_tap(IO_OUTPUT, buf, w);
+    return w;
 }
 
 std::streamsize stdout_write(std::string_view sw) {
     return stdout_write(sw.data(), sw.size());
 }
 
+std::streamsize fd_writev(bool err, std::span<const std::string_view> parts) {
+    std::streamsize total = 0;
+#ifdef _WIN32
+    for (std::string_view part: parts) {
+        while (!part.empty()) {
+            const std::streamsize w = fd_write(err, part.data(), part.size());
+            if (w < 0) return -1;
+            total += w;
+            part.remove_prefix(static_cast<std::size_t>(w));
+        }
+    }
+#else
+    constexpr int fds[] = { STDOUT_FILENO, STDERR_FILENO };
+    constexpr std::size_t max_iov = 64; // far below IOV_MAX on any supported platform
+
+    iovec iov[max_iov];
+    while (!parts.empty()) {
+        const std::size_t n = std::min(max_iov, parts.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            iov[i] = { const_cast<char*>(parts[i].data()), parts[i].size() };
+        }
+        parts = parts.subspan(n);
+
+        iovec* cur = iov;
+        int cnt = static_cast<int>(n);
+        while (cnt > 0) {
+            ssize_t w = writev(fds[err], cur, cnt);
+            ANSIPP_STATS_ADD(write_calls, 1);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            total += w;
+            ANSIPP_STATS_ADD(write_bytes, w);
+            for (; cnt > 0 && static_cast<std::size_t>(w) >= cur->iov_len; w -= cur->iov_len, ++cur, --cnt);
+            if (cnt > 0) {
+                cur->iov_base = static_cast<char*>(cur->iov_base) + w;
+                cur->iov_len -= static_cast<std::size_t>(w);
+            }
+        }
+    }
+#endif
+    return total;
+}
+
+std::streamsize stdout_write(std::span<const std::string_view> parts) {
+    const std::streamsize w = fd_writev(false, parts);
+    // all parts are written on success
+    if (w > 0) notify_tap(IO_OUTPUT, parts);
+    return w;
+}
+
 std::streamsize stderr_write(const void* buf, std::size_t sz) { return fd_write(true, buf, sz); }
 std::streamsize stderr_write(std::string_view sw) { return stderr_write(sw.data(), sw.size()); }
 
-std::streamsize stdin_read(void* buf, std::size_t sz) {
+std::streamsize fd_read(void* buf, std::size_t sz) {
 #ifdef _WIN32
     HANDLE in = GetStdHandle(STD_INPUT_HANDLE);
     if (in == INVALID_HANDLE_VALUE) return -1;
     
     DWORD result;
-    return ReadFile(in, buf, static_cast<DWORD>(sz), &result, nullptr) ? result : -1;
+    const std::streamsize r = ReadFile(in, buf, static_cast<DWORD>(sz), &result, nullptr) ? result : -1;
 #else
-    return read(STDIN_FILENO, buf, sz);
+    const std::streamsize r = read(STDIN_FILENO, buf, sz);
 #endif
+    ANSIPP_STATS_ADD(read_calls, 1);
+    if (r > 0) ANSIPP_STATS_ADD(read_bytes, r);
+    return r;
+}
+
+std::streamsize stdin_read(void* buf, std::size_t sz) {
+    const std::streamsize r = fd_read(buf, sz);
+    notify_tap(IO_INPUT, buf, r);
+    return r;
 }
 
 int stdin_read_ready(int timeout) {
+    ANSIPP_STATS_ADD(poll_calls, 1);
 #ifdef _WIN32
     
     HANDLE in = GetStdHandle(STD_INPUT_HANDLE);
@@ -59,6 +151,7 @@ int stdin_read_ready(int timeout) {
     } else if (result != WAIT_OBJECT_0) {
         return 0;
     }
+    ANSIPP_STATS_ADD(poll_wakeups, 1);
     
     // STD_INPUT_HANDLE will be signaled on ANY terminal event.
     // Even with DISABLED ENABLE_WINDOW_INPUT flag - SetConsoleMode(modes & (~ENABLE_WINDOW_INPUT))
@@ -90,7 +183,9 @@ int stdin_read_ready(int timeout) {
     return 0;
 #else
     pollfd stdin_pollfd = { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
-    return poll(&stdin_pollfd, 1, timeout);
+    const int ready = poll(&stdin_pollfd, 1, timeout);
+    if (ready > 0) ANSIPP_STATS_ADD(poll_wakeups, 1);
+    return ready;
 #endif
 }
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ios>
+#include <span>
+#include <string_view>
+
+#include <ansipp/io.hpp>
+
+namespace ansipp {
+
+/**
+ * @brief raw `stdout` (`err == false`) or `stderr` write, doesn't notify I/O tap (safe in signal handlers)
+ */
+std::streamsize fd_write(bool err, const void* buf, std::size_t sz);
+
+/**
+ * @brief raw gather write, all parts are written unless error occurs, doesn't notify I/O tap
+ */
+std::streamsize fd_writev(bool err, std::span<const std::string_view> parts);
+
+/**
+ * @brief passes `sz` bytes of successful I/O to installed tap (nothing if `sz <= 0` or there is no tap)
+ */
+void notify_tap(io_direction dir, const void* buf, std::streamsize sz);
+
+/**
+ * @brief passes all parts of successful gather write to installed tap as single I/O
+ */
+void notify_tap(io_direction dir, std::span<const std::string_view> parts);
+
+}
@@ -0,0 +1,279 @@
+#include <ansipp/record.hpp>
+#include <ansipp/error.hpp>
+
+#include <charconv>
+#include <cstdlib>
+#include <ctime>
+
+namespace ansipp {
+
+namespace {
+
+// length of UTF-8 sequence by its lead byte, `0` - invalid lead byte
+unsigned int utf8_length(unsigned char u) {
+    if (u >= 0xc2 && u <= 0xdf) return 2;
+    if (u >= 0xe0 && u <= 0xef) return 3;
+    if (u >= 0xf0 && u <= 0xf4) return 4;
+    return 0;
+}
+
+bool utf8_continuation(unsigned char u) { return (u & 0xc0) == 0x80; }
+
+void escape_byte(charbuf& out, unsigned char u) {
+    switch (u) {
+    case '"': out << "\\\""; break;
+    case '\\': out << "\\\\"; break;
+    case '\n': out << "\\n"; break;
+    case '\r': out << "\\r"; break;
+    case '\t': out << "\\t"; break;
+    case '\b': out << "\\b"; break;
+    case '\f': out << "\\f"; break;
+    default: {
+        constexpr char hex[] = "0123456789abcdef";
+        const char esc[] = { '\\', 'u', '0', '0', hex[u >> 4], hex[u & 0xf] };
+        out << std::string_view(esc, sizeof(esc));
+        break;
+    }
+    }
+}
+
+void put_utf8(std::string& out, std::uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+}
+
+bool parse_hex4(std::string_view json, std::size_t pos, std::uint32_t& v) {
+    if (pos + 4 > json.size()) return false;
+    const auto [ptr, ec] = std::from_chars(json.data() + pos, json.data() + pos + 4, v, 16);
+    return ec == std::errc() && ptr == json.data() + pos + 4;
+}
+
+std::size_t skip_ws(std::string_view s, std::size_t pos) {
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\r' || s[pos] == '\n')) ++pos;
+    return pos;
+}
+
+// looks up integer value of `"key": value` in flat JSON object
+int json_int(std::string_view json, std::string_view key) {
+    std::string quoted = "\"";
+    quoted += key;
+    quoted += '"';
+    std::size_t pos = json.find(quoted);
+    if (pos == std::string_view::npos) return 0;
+    pos = skip_ws(json, pos + quoted.size());
+    if (pos >= json.size() || json[pos] != ':') return 0;
+    pos = skip_ws(json, pos + 1);
+    int v = 0;
+    std::from_chars(json.data() + pos, json.data() + json.size(), v);
+    return v;
+}
+
+}
+
+void json_escape(charbuf& out, std::string_view data, std::string& carry) {
+    std::string joined;
+    if (!carry.empty()) {
+        joined = std::move(carry);
+        joined += data;
+        data = joined;
+        carry.clear();
+    }
+
+    std::size_t run = 0, i = 0;
+    while (i < data.size()) {
+        const unsigned char u = static_cast<unsigned char>(data[i]);
+        if (u >= 0x20 && u != '"' && u != '\\' && u != 0x7f && u < 0x80) { ++i; continue; }
+        if (const unsigned int len = utf8_length(u); len > 0) {
+            unsigned int valid = 1;
+            while (valid < len && i + valid < data.size() && utf8_continuation(static_cast<unsigned char>(data[i + valid]))) ++valid;
+            if (valid == len) { i += len; continue; }
+            if (i + valid == data.size()) { // sequence continues in the next chunk
+                out << data.substr(run, i - run);
+                carry.assign(data.substr(i));
+                return;
+            }
+        }
+        out << data.substr(run, i - run);
+        escape_byte(out, u);
+        run = ++i;
+    }
+    out << data.substr(run);
+}
+
+std::size_t json_unescape(std::string_view json, std::size_t pos, std::string& out) {
+    if (pos >= json.size() || json[pos] != '"') return std::string_view::npos;
+    for (std::size_t i = pos + 1; i < json.size();) {
+        const std::size_t special = json.find_first_of("\"\\", i);
+        if (special == std::string_view::npos) return std::string_view::npos;
+        out.append(json.substr(i, special - i));
+        if (json[special] == '"') return special + 1;
+        if (special + 1 >= json.size()) return std::string_view::npos;
+        i = special + 2;
+        switch (json[special + 1]) {
+        case '"': out.push_back('"'); break;
+        case '\\': out.push_back('\\'); break;
+        case '/': out.push_back('/'); break;
+        case 'b': out.push_back('\b'); break;
+        case 'f': out.push_back('\f'); break;
+        case 'n': out.push_back('\n'); break;
+        case 'r': out.push_back('\r'); break;
+        case 't': out.push_back('\t'); break;
+        case 'u': {
+            std::uint32_t cp;
+            if (!parse_hex4(json, i, cp)) return std::string_view::npos;
+            i += 4;
+            std::uint32_t low;
+            if (cp >= 0xd800 && cp < 0xdc00 && json.substr(i, 2) == "\\u" && parse_hex4(json, i + 2, low) && low >= 0xdc00 && low < 0xe000) {
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                i += 6;
+            }
+            put_utf8(out, cp);
+            break;
+        }
+        default: return std::string_view::npos;
+        }
+    }
+    return std::string_view::npos;
+}
+
+asciicast_recorder::~asciicast_recorder() { stop(); }
+
+void asciicast_recorder::start(std::error_code& ec, const std::string& path, vec size, bool input) {
+    if (file != nullptr) { ec = ansipp_error::already_initialized; return; }
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) { ec = last_error(); return; }
+
+    const char* term = std::getenv("TERM");
+    std::string carry_none;
+    charbuf header(256);
+    header << "{\"version\": 2, \"width\": " << size.x << ", \"height\": " << size.y
+        << ", \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ", \"env\": {\"TERM\": \"";
+    json_escape(header, term != nullptr ? term : "", carry_none);
+    header << "\"}}\n";
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        ec = last_error();
+        std::fclose(file);
+        file = nullptr;
+        return;
+    }
+
+    record_input = input;
+    started = clock::now();
+    stopping = false;
+    carry[IO_OUTPUT].clear();
+    carry[IO_INPUT].clear();
+    writer = std::thread(&asciicast_recorder::run, this);
+    set_io_tap(this);
+}
+
+void asciicast_recorder::stop() {
+    if (file == nullptr) return;
+    set_io_tap(nullptr);
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    cv.notify_one();
+    writer.join();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void asciicast_recorder::on_io(io_direction dir, std::string_view data) {
+    on_io_parts(dir, std::span<const std::string_view>(&data, 1));
+}
+
+void asciicast_recorder::on_io_parts(io_direction dir, std::span<const std::string_view> parts) {
+    if (dir == IO_INPUT && !record_input) return;
+    const double t = std::chrono::duration<double>(clock::now() - started).count();
+    bool full;
+    {
+        std::lock_guard lock(mutex);
+        pending << '[' << fixed_format(t, 6) << (dir == IO_INPUT ? ", \"i\", \"" : ", \"o\", \"");
+        for (std::string_view data: parts) json_escape(pending, data, carry[dir]);
+        pending << "\"]\n";
+        full = pending.size() >= flush_size;
+    }
+    if (full) cv.notify_one();
+}
+
+void asciicast_recorder::run() {
+    charbuf local(64 * 1024);
+    for (bool last = false; !last;) {
+        {
+            std::unique_lock lock(mutex);
+            cv.wait_for(lock, flush_interval, [&] { return stopping || pending.size() >= flush_size; });
+            last = stopping;
+            std::swap(local, pending);
+        }
+        if (local.size() > 0) std::fwrite(local.data(), 1, local.size(), file);
+        local.reset();
+    }
+    std::fflush(file);
+}
+
+asciicast_reader::~asciicast_reader() {
+    if (file != nullptr) std::fclose(file);
+}
+
+bool asciicast_reader::read_line() {
+    line.clear();
+    char buf[4096];
+    while (std::fgets(buf, sizeof(buf), file) != nullptr) {
+        line += buf;
+        if (!line.empty() && line.back() == '\n') return true;
+    }
+    return !line.empty();
+}
+
+void asciicast_reader::open(std::error_code& ec, const std::string& path) {
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) { ec = last_error(); return; }
+    if (!read_line() || json_int(line, "version") != 2) { ec = std::make_error_code(std::errc::invalid_argument); return; }
+    size = vec(json_int(line, "width"), json_int(line, "height"));
+}
+
+bool asciicast_reader::next(asciicast_event& e) {
+    while (file != nullptr && read_line()) {
+        if (parse_event(line, e)) return true;
+    }
+    return false;
+}
+
+bool asciicast_reader::parse_event(std::string_view line, asciicast_event& e) {
+    std::size_t pos = skip_ws(line, 0);
+    if (pos >= line.size() || line[pos] != '[') return false;
+    pos = skip_ws(line, pos + 1);
+    const auto [ptr, ec] = std::from_chars(line.data() + pos, line.data() + line.size(), e.time);
+    if (ec != std::errc()) return false;
+    pos = skip_ws(line, static_cast<std::size_t>(ptr - line.data()));
+    if (pos >= line.size() || line[pos] != ',') return false;
+
+    std::string type;
+    pos = json_unescape(line, skip_ws(line, pos + 1), type);
+    if (pos == std::string_view::npos || type.size() != 1) return false;
+    e.type = type[0];
+    pos = skip_ws(line, pos);
+    if (pos >= line.size() || line[pos] != ',') return false;
+
+    e.data.clear();
+    pos = json_unescape(line, skip_ws(line, pos + 1), e.data);
+    if (pos == std::string_view::npos) return false;
+    pos = skip_ws(line, pos);
+    return pos < line.size() && line[pos] == ']';
+}
+
+}
@@ -0,0 +1,106 @@
+#include <ansipp/render_pool.hpp>
+#include <ansipp/io.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace ansipp {
+
+render_pool::render_pool(unsigned int threads) {
+    if (threads == 0) threads = (std::max)(1U, std::thread::hardware_concurrency());
+    chunks.reserve(threads);
+    for (unsigned int i = 0; i < threads; ++i) chunks.emplace_back(4096);
+    errors.resize(threads);
+    parts.reserve(threads);
+    workers.reserve(threads - 1);
+    for (unsigned int i = 1; i < threads; ++i) workers.emplace_back(&render_pool::worker, this, i);
+}
+
+render_pool::~render_pool() {
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+    }
+    cv.notify_all();
+    for (std::thread& t: workers) t.join();
+}
+
+void render_pool::render_chunk(unsigned int index) {
+    const std::int64_t count = static_cast<std::int64_t>(chunks.size());
+    const int from = static_cast<int>(rows * static_cast<std::int64_t>(index) / count);
+    const int to = static_cast<int>(rows * static_cast<std::int64_t>(index + 1) / count);
+    charbuf& out = chunks[index];
+    // exception must not escape worker thread (`std::terminate`) or leave dispatch while workers use `ctx`
+    try {
+        for (int row = from; row < to; ++row) fn(ctx, out, row);
+    } catch (...) {
+        errors[index] = std::current_exception();
+    }
+}
+
+void render_pool::worker(unsigned int index) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) return;
+            seen = generation;
+        }
+        render_chunk(index);
+        if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) pending.notify_one();
+    }
+}
+
+void render_pool::dispatch(render_fn f, const void* c, int r) {
+    if (r <= 0) return;
+    fn = f;
+    ctx = c;
+    rows = r;
+    if (!workers.empty()) {
+        pending.store(static_cast<unsigned int>(workers.size()), std::memory_order_relaxed);
+        {
+            std::lock_guard lock(mutex);
+            ++generation;
+        }
+        cv.notify_all();
+    }
+    render_chunk(0);
+    for (unsigned int p = pending.load(std::memory_order_acquire); p != 0; p = pending.load(std::memory_order_acquire)) {
+        pending.wait(p, std::memory_order_acquire);
+    }
+    for (std::exception_ptr& e: errors) {
+        if (e == nullptr) continue;
+        const std::exception_ptr first = std::exchange(e, nullptr);
+        for (std::exception_ptr& rest: errors) rest = nullptr;
+        reset();
+        std::rethrow_exception(first);
+    }
+}
+
+std::span<const std::string_view> render_pool::view() {
+    parts.clear();
+    for (const charbuf& c: chunks) parts.push_back(c.view());
+    return parts;
+}
+
+void render_pool::append_to(charbuf& out) {
+    std::size_t size = 0;
+    for (const charbuf& c: chunks) size += c.size();
+    out.require(size);
+    for (const charbuf& c: chunks) out << c.view();
+    reset();
+}
+
+std::streamsize render_pool::flush() {
+    const std::streamsize result = stdout_write(view());
+    reset();
+    return result;
+}
+
+void render_pool::reset() {
+    for (charbuf& c: chunks) c.reset();
+}
+
+}
@@ -0,0 +1,72 @@
+#include <ansipp/resource.hpp>
+
+#ifndef _WIN32
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+namespace ansipp {
+
+#ifdef _WIN32
+
+void* mmap_charbuf_resource::reallocate(void* ptr, std::size_t, std::size_t, std::size_t new_size) {
+    return std::realloc(ptr, new_size);
+}
+
+void mmap_charbuf_resource::deallocate(void* ptr, std::size_t) { std::free(ptr); }
+
+#else
+
+namespace {
+
+std::size_t page_round(std::size_t size) {
+    static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return (size + page - 1) / page * page;
+}
+
+void* map_pages(std::size_t size) {
+    void* p = mmap(nullptr, page_round(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+void advise_huge([[maybe_unused]] void* p, [[maybe_unused]] std::size_t size) {
+#ifdef MADV_HUGEPAGE
+    madvise(p, page_round(size), MADV_HUGEPAGE); // only a hint, failure (i.e. THP disabled) is fine
+#endif
+}
+
+}
+
+void* mmap_charbuf_resource::reallocate(void* ptr, std::size_t size, std::size_t used, std::size_t new_size) {
+    const bool old_mapped = ptr != nullptr && mapped(size);
+    if (!old_mapped && !mapped(new_size)) return std::realloc(ptr, new_size);
+
+    void* nb;
+#ifdef MREMAP_MAYMOVE
+    if (old_mapped && mapped(new_size)) {
+        nb = mremap(ptr, page_round(size), page_round(new_size), MREMAP_MAYMOVE);
+        if (nb == MAP_FAILED) return nullptr;
+        if (new_size >= huge_min) advise_huge(nb, new_size);
+        return nb;
+    }
+#endif
+
+    // moving between heap and mapping (or no `mremap`): copy used part
+    nb = mapped(new_size) ? map_pages(new_size) : std::malloc(new_size);
+    if (nb == nullptr) return nullptr;
+    if (mapped(new_size) && new_size >= huge_min) advise_huge(nb, new_size);
+    if (ptr != nullptr) {
+        std::memcpy(nb, ptr, used);
+        deallocate(ptr, size);
+    }
+    return nb;
+}
+
+void mmap_charbuf_resource::deallocate(void* ptr, std::size_t size) {
+    if (ptr == nullptr) return;
+    if (mapped(size)) munmap(ptr, page_round(size)); else std::free(ptr);
+}
+
+#endif
+
+}
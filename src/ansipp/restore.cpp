@@ -13,6 +13,7 @@
 #endif
 
 #include "restore.hpp"
+#include "io.hpp"
 
 namespace ansipp {
 
@@ -38,7 +39,8 @@ void restore_mode() {
 }
 
 void restore_terminal_state() {
-    __ansipp_restore.escapes.restore([](const charbuf& restore_esc) { stdout_write(restore_esc.view()); });
+    // called from signal handlers: I/O tap may lock or allocate (i.e. `asciicast_recorder`), so it's bypassed
+    __ansipp_restore.escapes.restore([](const charbuf& restore_esc) { fd_write(false, restore_esc.data(), restore_esc.size()); });
 }
 
 void restore_signal() {
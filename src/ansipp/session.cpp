@@ -0,0 +1,42 @@
+#include <ansipp/session.hpp>
+
+namespace ansipp {
+
+namespace {
+
+session active;
+
+// terminals known to implement REP, there is no query for it
+bool version_rep(std::string_view version) {
+    constexpr std::string_view known[] = { "XTerm", "kitty", "WezTerm", "foot", "ghostty", "contour" };
+    for (std::string_view k: known) if (version.starts_with(k)) return true;
+    return false;
+}
+
+// absence of 24-bit colors is known only for terminals reporting VT100 class in DA1 (Linux console `?6c`,
+// Apple Terminal `?1;2c`), others may support them without `COLORTERM` (i.e. over ssh) and aren't downgraded
+bool lacks_truecolor(const terminal_caps& caps) {
+    return !caps.truecolor && caps.da1_class >= 0 && caps.da1_class < 62;
+}
+
+}
+
+session session::select(const terminal_caps& caps, const config& cfg) {
+    session s;
+    s.caps = caps;
+    s.mouse_encoding = cfg.mouse_encoding;
+    if (!caps.answered) return s; // nothing is confirmed, keep defaults
+
+    if (lacks_truecolor(caps)) s.truecolor = false;
+    s.ech = caps.da1_class >= 62; // ECH is part of VT220
+    s.rep = version_rep(caps.version);
+    s.synchronized_output = caps.synchronized_output;
+    if (caps.mouse_sgr) s.mouse_encoding = MOUSE_SGR;
+    return s;
+}
+
+const session& current_session() { return active; }
+
+void set_session(const session& s) { active = s; }
+
+}
@@ -0,0 +1,47 @@
+#include <ansipp/sgr_cache.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace ansipp {
+
+sgr_cache::sgr_cache(std::size_t capacity):
+    slots(std::bit_ceil(std::clamp(capacity, ways, ways << 24))),
+    set_mask(slots.size() / ways - 1),
+    truecolor(current_session().truecolor) 
+{
+    clear();
+}
+
+sgr_cache::entry& sgr_cache::miss(entry* set, packed_attrs a) {
+    ++miss_count;
+    entry* victim = set;
+    for (std::size_t i = 0; i < ways; ++i) {
+        if (set[i].size == 0) {
+            victim = set + i;
+            break;
+        }
+        if (set[i].last_use < victim->last_use) victim = set + i;
+    }
+    if (victim->size != 0) ++eviction_count;
+
+    char tmp[packed_attrs::max_size()]; // `write_to` may touch more bytes than it writes
+    const std::size_t size = static_cast<std::size_t>(a.write_to(tmp) - tmp);
+    std::memcpy(victim->bytes, tmp, size);
+    victim->size = static_cast<unsigned char>(size);
+    victim->key = a.key;
+    victim->last_use = ++tick;
+    return *victim;
+}
+
+void sgr_cache::clear() {
+    for (entry& e: slots) e.size = 0;
+    truecolor = current_session().truecolor;
+}
+
+std::size_t sgr_cache::size() const {
+    return static_cast<std::size_t>(std::count_if(slots.begin(), slots.end(), [](const entry& e) { return e.size != 0; }));
+}
+
+}
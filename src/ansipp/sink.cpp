@@ -0,0 +1,86 @@
+#include <ansipp/sink.hpp>
+#include <ansipp/io.hpp>
+#include <ansipp/error.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace ansipp {
+
+output_sink::output_sink(): writer(&output_sink::run, this) {}
+
+output_sink::~output_sink() {
+    push(&stop_marker);
+    writer.join();
+}
+
+charbuf& output_sink::local() {
+    static thread_local charbuf buf(4096);
+    return buf;
+}
+
+void output_sink::push(segment* s) {
+    segment* h = head.load(std::memory_order_relaxed);
+    do {
+        s->next = h;
+    } while (!head.compare_exchange_weak(h, s, std::memory_order_release, std::memory_order_relaxed));
+    if (h == nullptr) head.notify_one(); // writer sleeps only on empty queue
+}
+
+void output_sink::submit(std::string_view data) {
+    if (data.empty()) return;
+    segment* s = static_cast<segment*>(std::malloc(sizeof(segment) + data.size()));
+    if (s == nullptr) [[unlikely]] throw std::bad_alloc();
+    s->size = data.size();
+    std::memcpy(s->data(), data.data(), data.size());
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    push(s);
+}
+
+std::error_code output_sink::flush() {
+    const std::uint64_t target = submitted.load(std::memory_order_relaxed);
+    for (std::uint64_t w = written.load(std::memory_order_acquire); w < target; w = written.load(std::memory_order_acquire)) {
+        written.wait(w, std::memory_order_acquire);
+    }
+    return error();
+}
+
+void output_sink::run() {
+    constexpr std::size_t max_batch = 64;
+    std::string_view parts[max_batch];
+    segment* batch[max_batch];
+
+    for (bool stop = false; !stop; ) {
+        head.wait(nullptr, std::memory_order_acquire);
+        segment* list = head.exchange(nullptr, std::memory_order_acquire);
+
+        // queue is LIFO stack, reverse to restore submission order
+        segment* fifo = nullptr;
+        while (list != nullptr) {
+            segment* next = list->next;
+            list->next = fifo;
+            fifo = list;
+            list = next;
+        }
+
+        while (fifo != nullptr) {
+            std::size_t n = 0;
+            for (; fifo != nullptr && n < max_batch; fifo = fifo->next) {
+                if (fifo == &stop_marker) { stop = true; continue; }
+                batch[n] = fifo;
+                parts[n] = std::string_view(fifo->data(), fifo->size);
+                ++n;
+            }
+            if (stdout_write(std::span<const std::string_view>(parts, n)) < 0) {
+                int none = 0;
+                error_value.compare_exchange_strong(none, last_error().value(), std::memory_order_release, std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < n; ++i) std::free(batch[i]);
+            written.fetch_add(n, std::memory_order_release);
+            written.notify_all();
+        }
+    }
+}
+
+}
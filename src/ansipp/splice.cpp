@@ -0,0 +1,129 @@
+#include <ansipp/splice.hpp>
+#include <ansipp/io.hpp>
+#include <ansipp/stats.hpp>
+
+#include <cstdlib>
+
+#ifdef __linux__
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <errno.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <sys/uio.h>
+#endif
+
+#include "io.hpp"
+
+namespace ansipp {
+
+namespace {
+
+std::streamsize write_all(std::string_view data) {
+    const std::streamsize total = static_cast<std::streamsize>(data.size());
+    for (std::streamsize w; !data.empty(); data.remove_prefix(static_cast<std::size_t>(w))) {
+        if ((w = stdout_write(data)) < 0) return -1;
+    }
+    return total;
+}
+
+}
+
+splice_output::splice_output(std::size_t window_size, bool use_vmsplice): window(window_size), buf(nullptr, 0) {
+    if (!use_vmsplice || !init_ring()) {
+        ring = static_cast<char*>(std::malloc(window));
+        if (ring == nullptr) throw std::bad_alloc();
+    }
+    next_window();
+}
+
+splice_output::~splice_output() {
+    flush();
+    release_ring();
+}
+
+#ifdef __linux__
+
+bool splice_output::init_ring() {
+    struct stat st;
+    if (fstat(STDOUT_FILENO, &st) == -1 || !S_ISFIFO(st.st_mode)) return false;
+
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    window = (window + page - 1) / page * page;
+
+    // bigger pipe means less context switches, but it may be limited by /proc/sys/fs/pipe-max-size,
+    // pipe is shared with reader, so it's only enlarged (shrinking could fail or slow down other writers)
+    int pipe_size = fcntl(STDOUT_FILENO, F_GETPIPE_SZ);
+    if (pipe_size <= 0) return false;
+    if (static_cast<std::size_t>(pipe_size) < window && fcntl(STDOUT_FILENO, F_SETPIPE_SZ, static_cast<int>(window)) > 0) {
+        pipe_size = fcntl(STDOUT_FILENO, F_GETPIPE_SZ);
+        if (pipe_size <= 0) return false;
+    }
+
+    // window content must not be overwritten until reader consumes it,
+    // pipe never holds more than pipe_size bytes, so bytes older than window + pipe_size are already consumed
+    // (as long as reader copies them out with `read` and keeps pipe size, see `splice_output`)
+    ring_size = window + (static_cast<std::size_t>(pipe_size) + page - 1) / page * page;
+
+    const int fd = memfd_create("ansipp_splice", MFD_CLOEXEC);
+    if (fd == -1) return false;
+
+    bool ok = false;
+    void* area = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(ring_size)) == 0) {
+        area = mmap(nullptr, ring_size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (area != MAP_FAILED) {
+        char* a = static_cast<char*>(area);
+        ok = mmap(a, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED
+            && mmap(a + ring_size, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+        if (ok) ring = a; else munmap(area, ring_size * 2);
+    }
+    close(fd); // mappings keep memory alive
+    spliced = ok;
+    return ok;
+}
+
+void splice_output::release_ring() {
+    if (spliced) munmap(ring, ring_size * 2); else std::free(ring);
+}
+
+std::streamsize splice_output::flush() {
+    if (!spliced) return write_all(buf.flush());
+
+    std::string_view data = buf.view();
+    std::streamsize total = 0;
+    while (!data.empty()) {
+        iovec iov = { const_cast<char*>(data.data()), data.size() };
+        std::streamsize w = vmsplice(STDOUT_FILENO, &iov, 1, 0);
+        ANSIPP_STATS_ADD(write_calls, 1);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            // not spliceable after all (i.e. stdout replaced with dup2), remaining data will be written
+            if ((w = stdout_write(data)) < 0) { total = -1; break; }
+        } else {
+            ANSIPP_STATS_ADD(write_bytes, w);
+            notify_tap(IO_OUTPUT, data.data(), w); // `stdout_write` above notifies itself and counts its bytes
+        }
+        total += w;
+        data.remove_prefix(static_cast<std::size_t>(w));
+    }
+    head = (head + buf.size()) % ring_size;
+    next_window();
+    return total;
+}
+
+#else
+
+bool splice_output::init_ring() { return false; }
+void splice_output::release_ring() { std::free(ring); }
+
+std::streamsize splice_output::flush() { return write_all(buf.flush()); }
+
+#endif
+
+void splice_output::next_window() {
+    buf.assign(ring + head, window);
+}
+
+}
@@ -0,0 +1,32 @@
+#include <ansipp/stats.hpp>
+
+namespace ansipp {
+
+stats_counters& stats_storage() {
+    static stats_counters counters;
+    return counters;
+}
+
+stats get_stats() {
+    const stats_counters& c = stats_storage();
+    return stats {
+        c.write_calls.load(std::memory_order_relaxed),
+        c.write_bytes.load(std::memory_order_relaxed),
+        c.read_calls.load(std::memory_order_relaxed),
+        c.read_bytes.load(std::memory_order_relaxed),
+        c.poll_calls.load(std::memory_order_relaxed),
+        c.poll_wakeups.load(std::memory_order_relaxed),
+        c.charbuf_reallocs.load(std::memory_order_relaxed),
+        c.charbuf_realloc_bytes.load(std::memory_order_relaxed)
+    };
+}
+
+void reset_stats() {
+    stats_counters& c = stats_storage();
+    for (std::atomic<std::uint64_t>* v: { &c.write_calls, &c.write_bytes, &c.read_calls, &c.read_bytes,
+            &c.poll_calls, &c.poll_wakeups, &c.charbuf_reallocs, &c.charbuf_realloc_bytes }) {
+        v->store(0, std::memory_order_relaxed);
+    }
+}
+
+}
@@ -0,0 +1,126 @@
+#include <ansipp/trace.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace ansipp {
+
+void latency_histogram::add(std::int64_t ns) {
+    if (ns < 0) ns = 0;
+    const std::uint64_t us = static_cast<std::uint64_t>(ns / 1000);
+    const std::size_t bucket = (std::min)(static_cast<std::size_t>(std::bit_width(us)), bucket_count - 1);
+    ++buckets[bucket];
+    ++count;
+    total_ns += ns;
+    if (ns > max_ns) max_ns = ns;
+}
+
+std::int64_t latency_histogram::percentile_ns(double p) const {
+    if (count == 0) return 0;
+    const std::uint64_t rank = static_cast<std::uint64_t>(p * static_cast<double>(count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return (std::min)(max_ns, static_cast<std::int64_t>(1000) << i);
+    }
+    return max_ns;
+}
+
+latency_tracer::latency_tracer(std::size_t capacity, io_tap* forward): max_events((std::max)(capacity, std::size_t(1))), forward(forward) {
+    events_ring.reserve(max_events);
+}
+
+namespace {
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+void latency_tracer::on_io(io_direction dir, std::string_view data) {
+    record(dir, data.size(), now_ns());
+    if (forward != nullptr) forward->on_io(dir, data);
+}
+
+void latency_tracer::on_io_parts(io_direction dir, std::span<const std::string_view> parts) {
+    std::size_t bytes = 0;
+    for (std::string_view part: parts) bytes += part.size();
+    record(dir, bytes, now_ns());
+    if (forward != nullptr) forward->on_io_parts(dir, parts);
+}
+
+void latency_tracer::record(io_direction dir, std::size_t bytes, std::int64_t ts_ns) {
+    std::lock_guard lock(mutex);
+    event e { dir, ts_ns, bytes, -1 };
+    if (dir == IO_INPUT) {
+        pending_inputs.push_back(ts_ns);
+    } else if (!pending_inputs.empty()) {
+        e.input_ts_ns = pending_inputs.front();
+        for (std::int64_t input: pending_inputs) hist.add(ts_ns - input);
+        pending_inputs.clear();
+    }
+
+    if (events_ring.size() < max_events) {
+        events_ring.push_back(e);
+    } else {
+        events_ring[next] = e;
+        next = (next + 1) % events_ring.size();
+        ++dropped;
+    }
+}
+
+std::vector<latency_tracer::event> latency_tracer::events() const {
+    std::lock_guard lock(mutex);
+    std::vector<event> result(events_ring.begin() + static_cast<std::ptrdiff_t>(next), events_ring.end());
+    result.insert(result.end(), events_ring.begin(), events_ring.begin() + static_cast<std::ptrdiff_t>(next));
+    return result;
+}
+
+latency_histogram latency_tracer::histogram() const {
+    std::lock_guard lock(mutex);
+    return hist;
+}
+
+std::uint64_t latency_tracer::dropped_events() const {
+    std::lock_guard lock(mutex);
+    return dropped;
+}
+
+void latency_tracer::clear() {
+    std::lock_guard lock(mutex);
+    events_ring.clear();
+    next = 0;
+    dropped = 0;
+    pending_inputs.clear();
+    hist = latency_histogram {};
+}
+
+void latency_tracer::write_chrome_trace(std::FILE* f) const {
+    const std::vector<event> all = events();
+    const std::int64_t origin = all.empty() ? 0 : all.front().ts_ns;
+    // trace event timestamps are microseconds
+    auto us = [&](std::int64_t ns) { return static_cast<double>(ns - origin) / 1000.0; };
+
+    std::fprintf(f, "{\"traceEvents\":[\n");
+    const char* sep = "";
+    std::vector<std::int64_t> unanswered;
+    for (const event& e: all) {
+        std::fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":1,\"args\":{\"bytes\":%llu}}",
+            sep, e.dir == IO_INPUT ? "input" : "output", us(e.ts_ns), static_cast<unsigned long long>(e.bytes));
+        sep = ",\n";
+        if (e.dir == IO_INPUT) {
+            unanswered.push_back(e.ts_ns);
+            continue;
+        }
+        for (std::int64_t input: unanswered) {
+            std::fprintf(f, "%s{\"name\":\"latency\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":2}",
+                sep, us(input), static_cast<double>(e.ts_ns - input) / 1000.0);
+        }
+        unanswered.clear();
+    }
+    std::fprintf(f, "\n],\"displayTimeUnit\":\"ns\"}\n");
+}
+
+}
@@ -32,6 +32,37 @@ TEST_CASE("attrs: colors", "[attrs]") {
     std::cout << attrs().off();
 }
 
+TEST_CASE("attrs: bright colors", "[attrs]") {
+    // bright colors are offset by 60 from normal ones: 90-97 foreground, 100-107 background
+    REQUIRE( esc_str(attrs().fg(BLACK, true)) == "\33" "[90m" );
+    REQUIRE( esc_str(attrs().fg(YELLOW, true)) == "\33" "[93m" );
+    REQUIRE( esc_str(attrs().fg(WHITE, true)) == "\33" "[97m" );
+    REQUIRE( esc_str(attrs().bg(BLACK, true)) == "\33" "[100m" );
+    REQUIRE( esc_str(attrs().bg(BLUE, true)) == "\33" "[104m" );
+    REQUIRE( esc_str(attrs().bg(WHITE, true)) == "\33" "[107m" );
+    REQUIRE( esc_str(attrs().fg(RED, true).bg(CYAN, true)) == "\33" "[91;106m" );
+    REQUIRE( esc_str(packed_attrs().fg(GREEN, true).bg(MAGENTA, true)) == "\33" "[92;105m" );
+}
+
+TEST_CASE("attrs: packed", "[attrs]") {
+    REQUIRE( esc_str(packed_attrs()) == "\33" "[m" );
+    REQUIRE( esc_str(packed_attrs().fg(RED).bg(BLUE).on(BOLD)) == "\33" "[1;31;44m" );
+    REQUIRE( esc_str(packed_attrs().off().fg(YELLOW, true).bg()) == "\33" "[0;93;49m" );
+    REQUIRE( esc_str(packed_attrs().fg(static_cast<unsigned char>(208)).bg(rgb(1, 2, 3))) == "\33" "[38;5;208;48;2;1;2;3m" );
+    REQUIRE( esc_str(packed_attrs().fg(RED).fg(GREEN)) == "\33" "[32m" ); // the last color wins
+
+    packed_attrs all;
+    all.off().fg(rgb(255, 255, 255)).bg(rgb(255, 255, 255));
+    for (style s: { BOLD, DIM, ITALIC, UNDERLINE, BLINK, BLINK_FAST, INVERSE, HIDDEN, STRIKETHROUGH }) all.on(s);
+    REQUIRE( esc_str(all) == "\33" "[0;1;2;3;4;5;6;7;8;9;38;2;255;255;255;48;2;255;255;255m" );
+    REQUIRE( esc_str(all).size() <= packed_attrs::max_size() );
+
+    REQUIRE( packed_attrs().fg(RED) == packed_attrs().fg(RED) );
+    REQUIRE( packed_attrs().fg(RED) != packed_attrs().bg(RED) );
+    REQUIRE( packed_attrs().fg(RED) != packed_attrs().fg(RED, true) );
+    REQUIRE( packed_attrs().fg() != packed_attrs() );
+}
+
 bool operator==(const rgb& a, const rgb& b) { return a.r == b.r && a.g == b.g && a.b == b.b; } 
 
 TEST_CASE("rgb: lerp", "[rgb]") {
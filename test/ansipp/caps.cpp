@@ -0,0 +1,156 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <ansipp/caps.hpp>
+
+using namespace ansipp;
+
+TEST_CASE("caps: parse replies", "[caps]") {
+    terminal_caps caps;
+    REQUIRE( !parse_caps_replies("", caps) );
+    REQUIRE( caps == terminal_caps {} );
+
+    // replies of kitty like terminal, with key press in the middle
+    const std::string_view replies =
+        "\x1b[?2026;2$y"
+        "\x1b[?1006;1$y"
+        "x"
+        "\x1b[?2004;0$y"
+        "\x1b[?1004;4$y"
+        "\x1bP>|kitty(0.35.2)\x1b\\"
+        "\x1b[>1;4000;29c";
+    REQUIRE( !parse_caps_replies(replies, caps) );
+    REQUIRE( caps.synchronized_output );
+    REQUIRE( caps.mouse_sgr );
+    REQUIRE( !caps.bracketed_paste );
+    REQUIRE( !caps.focus_reporting );
+    REQUIRE( caps.version == "kitty(0.35.2)" );
+    REQUIRE( caps.truecolor );
+    REQUIRE( caps.da2_type == 1 );
+    REQUIRE( caps.da2_version == 4000 );
+    REQUIRE( !caps.answered );
+
+    REQUIRE( parse_caps_replies(std::string(replies) + "\x1b[?62;4;22c", caps) );
+    REQUIRE( caps.answered );
+    REQUIRE( caps.da1_class == 62 );
+    REQUIRE( caps.sixel );
+}
+
+TEST_CASE("caps: minimal terminal", "[caps]") {
+    terminal_caps caps;
+    REQUIRE( parse_caps_replies("\x1b[?1;2c", caps) );
+    REQUIRE( caps.answered );
+    REQUIRE( !caps.synchronized_output );
+    REQUIRE( !caps.sixel );
+    REQUIRE( caps.da2_type == -1 );
+    REQUIRE( caps.version.empty() );
+
+    // incomplete sequence is ignored
+    terminal_caps partial;
+    REQUIRE( !parse_caps_replies("\x1b[?2026;1", partial) );
+    REQUIRE( partial == terminal_caps {} );
+}
+
+TEST_CASE("caps: cache", "[caps]") {
+    terminal_caps caps;
+    caps.truecolor = true;
+    caps.mouse_sgr = true;
+    caps.da1_class = 63;
+    caps.da2_type = 41;
+    caps.da2_version = 390;
+    caps.version = "XTerm(390)";
+    caps.answered = true;
+
+    terminal_caps loaded;
+    const std::string line = serialize_caps("xterm-256color;;", caps);
+    REQUIRE( !deserialize_caps(line, "xterm;;", loaded) );
+    REQUIRE( deserialize_caps(line, "xterm-256color;;", loaded) );
+    REQUIRE( loaded == caps );
+    REQUIRE( !deserialize_caps("xterm;;\tbad\t1\t2\t3\t", "xterm;;", loaded) );
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "ansipp_caps_test";
+    std::filesystem::remove_all(dir);
+    const std::string path = (dir / "caps").string();
+    REQUIRE( !load_caps(path, "a", loaded) );
+
+    terminal_caps other;
+    other.synchronized_output = true;
+    other.answered = true;
+    REQUIRE( save_caps(path, "a", caps) );
+    REQUIRE( save_caps(path, "b", other) );
+    REQUIRE( save_caps(path, "a", other) ); // replaces entry
+
+    REQUIRE( load_caps(path, "a", loaded) );
+    REQUIRE( loaded == other );
+    REQUIRE( load_caps(path, "b", loaded) );
+    REQUIRE( loaded == other );
+    REQUIRE( !load_caps(path, "c", loaded) );
+
+    // concurrent writers may drop each other's entries, but never corrupt file
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&, t] { for (int i = 0; i < 20; ++i) save_caps(path, "t" + std::to_string(t), caps); });
+    }
+    for (std::thread& w: writers) w.join();
+    std::ifstream in(path);
+    int entries = 0;
+    for (std::string line; std::getline(in, line); ++entries) {
+        const std::string key = line.substr(0, line.find('\t'));
+        REQUIRE( deserialize_caps(line, key, loaded) );
+    }
+    REQUIRE( entries >= 1 );
+
+    // temporary files are renamed into place
+    REQUIRE( std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()) == 1 );
+    std::filesystem::remove_all(dir);
+}
+
+#ifndef _WIN32
+
+TEST_CASE("caps: cache key", "[caps]") {
+    constexpr const char* vars[] = { "TERM", "TERM_PROGRAM", "TERM_PROGRAM_VERSION", "VTE_VERSION", "KONSOLE_VERSION",
+        "XTERM_VERSION", "TERMINAL_EMULATOR", "KITTY_WINDOW_ID", "ALACRITTY_WINDOW_ID", "WEZTERM_PANE", "WT_SESSION",
+        "TMUX", "STY", "ZELLIJ" };
+    std::vector<std::pair<const char*, std::optional<std::string>>> saved;
+    for (const char* name: vars) {
+        const char* v = std::getenv(name);
+        saved.emplace_back(name, v == nullptr ? std::nullopt : std::optional<std::string>(v));
+        unsetenv(name);
+    }
+
+    setenv("TERM", "xterm-256color", 1);
+    REQUIRE( caps_cache_key().empty() ); // shared by many emulators, not cached
+
+    setenv("VTE_VERSION", "7600", 1);
+    const std::string vte = caps_cache_key();
+    unsetenv("VTE_VERSION");
+    setenv("KITTY_WINDOW_ID", "3", 1);
+    const std::string kitty = caps_cache_key();
+    setenv("KITTY_WINDOW_ID", "4", 1);
+    REQUIRE( caps_cache_key() == kitty ); // window id isn't part of key
+    setenv("TMUX", "/tmp/tmux-0/default,1,0", 1);
+    const std::string kitty_tmux = caps_cache_key();
+
+    REQUIRE( vte == "xterm-256color;;;VTE_VERSION=7600" );
+    REQUIRE( kitty == "xterm-256color;;;KITTY_WINDOW_ID" );
+    REQUIRE( kitty_tmux == "xterm-256color;;;KITTY_WINDOW_ID;TMUX" );
+
+    unsetenv("KITTY_WINDOW_ID");
+    setenv("TERM_PROGRAM", "WezTerm", 1);
+    setenv("TERM_PROGRAM_VERSION", "20240203", 1);
+    REQUIRE( caps_cache_key() == "xterm-256color;WezTerm;20240203;TMUX" );
+
+    for (const auto& [name, v]: saved) {
+        if (v) setenv(name, v->c_str(), 1); else unsetenv(name);
+    }
+}
+
+#endif
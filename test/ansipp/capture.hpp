@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef _WIN32
+
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @brief redirects `stdout` to pipe (drained by background thread) or to specified file descriptor
+ */
+class stdout_capture {
+    int saved = -1;
+    int read_fd = -1;
+    std::string data;
+    std::thread reader;
+
+public:
+    stdout_capture() {
+        int fds[2];
+        if (pipe(fds) != 0) return;
+        read_fd = fds[0];
+        redirect(fds[1]);
+        reader = std::thread([this] {
+            char buf[4096];
+            for (ssize_t r; (r = read(read_fd, buf, sizeof(buf))) != 0;) {
+                if (r > 0) data.append(buf, static_cast<std::size_t>(r));
+            }
+        });
+    }
+
+    /**
+     * @brief redirects to `fd` (i.e. regular file), takes ownership of it
+     */
+    explicit stdout_capture(int fd) { redirect(fd); }
+
+    stdout_capture(const stdout_capture&) = delete;
+    stdout_capture& operator=(const stdout_capture&) = delete;
+    ~stdout_capture() { if (saved != -1) finish(); }
+
+    /**
+     * @brief restores `stdout` and returns everything written to pipe
+     */
+    std::string finish() {
+        dup2(saved, STDOUT_FILENO); // closes the last write end, reader gets EOF
+        close(saved);
+        saved = -1;
+        if (reader.joinable()) reader.join();
+        if (read_fd != -1) close(read_fd);
+        read_fd = -1;
+        return std::move(data);
+    }
+
+private:
+    void redirect(int fd) {
+        saved = dup(STDOUT_FILENO);
+        dup2(fd, STDOUT_FILENO);
+        close(fd);
+    }
+};
+
+#endif
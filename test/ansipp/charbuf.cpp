@@ -2,9 +2,12 @@
 #include <catch2/benchmark/catch_benchmark_all.hpp>
 
 #include <ansipp/charbuf.hpp>
+#include <ansipp/resource.hpp>
 #include <limits>
 #include <numbers>
 #include <cstring>
+#include <memory_resource>
+#include <new>
 
 using namespace ansipp;
 
@@ -28,6 +31,33 @@ TEST_CASE("charbuf: integral", "[charbuf]") {
     REQUIRE( (cb.reset() << uint_max).view() == std::to_string(uint_max) );
 }
 
+TEST_CASE("charbuf: integral padding and grouping", "[charbuf]") {
+    charbuf cb;
+    REQUIRE( (cb.reset() << integral_format(1048576U).grouping(',')).view() == "1,048,576" );
+    REQUIRE( (cb.reset() << integral_format(-1048576).grouping(',')).view() == "-1,048,576" );
+    REQUIRE( (cb.reset() << integral_format(123).grouping(',')).view() == "123" );
+    REQUIRE( (cb.reset() << integral_format(0xdeadbeefU, 16, true).grouping('_', 4)).view() == "DEAD_BEEF" );
+    REQUIRE( (cb.reset() << integral_format(42).pad(6)).view() == "    42" );
+    REQUIRE( (cb.reset() << integral_format(42).pad(6, LEFT)).view() == "42    " );
+    REQUIRE( (cb.reset() << integral_format(-42).pad(7, CENTER, '.')).view() == "..-42.." );
+    REQUIRE( (cb.reset() << integral_format(-7, 10, false, 3).pad(5)).view() == "  -07" );
+    REQUIRE( (cb.reset() << integral_format(1234567).grouping(' ').pad(12) << '|').view() == "   1 234 567|" );
+    REQUIRE( (cb.reset() << integral_format(1234567).pad(3)).view() == "1234567" );
+
+    // zero padded width is longer than digits of any integer
+    std::string wide = "00";
+    for (int i = 0; i < 26; ++i) wide += ",000";
+    wide.back() = '5';
+    REQUIRE( (cb.reset() << integral_format(5U, 10, false, 80).grouping(',')).view() == wide );
+    REQUIRE( (cb.reset() << integral_format(-5, 10, false, 81).grouping(',') << '|').view() == "-" + wide + "|" );
+}
+
+TEST_CASE("charbuf: small_uint", "[charbuf]") {
+    charbuf cb;
+    REQUIRE( (cb.reset() << small_uint(0) << ';' << small_uint(7) << ';' << small_uint(42) << ';' << small_uint(999)).view() == "0;7;42;999" );
+    REQUIRE( (cb.reset() << small_uint(1000) << ';' << small_uint(123456)).view() == "1000;123456" );
+}
+
 TEST_CASE("charbuf: floating", "[charbuf]") {
     charbuf cb;
     REQUIRE((cb.reset() << std::numbers::pi).view() == "3.141592653589793");
@@ -38,6 +68,41 @@ TEST_CASE("charbuf: floating", "[charbuf]") {
     REQUIRE((cb.reset() << floating_format(std::numbers::pi, std::chars_format::fixed, 64)).view() == "3.1415926535897931159979634685441851615905761718750000000000000000");
 }
 
+TEST_CASE("charbuf: fixed", "[charbuf]") {
+    charbuf cb;
+    REQUIRE((cb.reset() << fixed_format(std::numbers::pi)).view() == "3.14");
+    REQUIRE((cb.reset() << fixed_format(std::numbers::pi, 0)).view() == "3");
+    REQUIRE((cb.reset() << fixed_format(-1234.5678, 3)).view() == "-1234.568");
+    REQUIRE((cb.reset() << fixed_format(-0.001, 2)).view() == "-0.00");
+    REQUIRE((cb.reset() << fixed_format(0.05f, 1)).view() == "0.1");
+    REQUIRE((cb.reset() << fixed_format(99.999, 2)).view() == "100.00");
+    REQUIRE((cb.reset() << fixed_format(1e20, 1)).view() == "100000000000000000000.0");
+    REQUIRE((cb.reset() << fixed_format(std::numeric_limits<double>::infinity(), 1)).view() == "inf");
+
+    char expected[64];
+    for (unsigned int precision = 0; precision < 7; ++precision) {
+        for (int i = -1000; i < 1000; ++i) {
+            const double v = i * 1.2345678901;
+            const std::to_chars_result r = std::to_chars(expected, expected + sizeof(expected), v, std::chars_format::fixed, precision);
+            REQUIRE( (cb.reset() << fixed_format(v, precision)).view() == std::string_view(expected, r.ptr) );
+        }
+    }
+}
+
+TEST_CASE("charbuf: fixed vs to_chars", "[!benchmark][charbuf]") {
+    charbuf cb(4096);
+    BENCHMARK("std::to_chars") {
+        cb.reset();
+        for (int i = 0; i < 100; ++i) cb << floating_format(i * 1.37, std::chars_format::fixed, 2) << ' ';
+        return cb.size();
+    };
+    BENCHMARK("fixed_format") {
+        cb.reset();
+        for (int i = 0; i < 100; ++i) cb << fixed_format(i * 1.37, 2) << ' ';
+        return cb.size();
+    };
+}
+
 TEST_CASE("charbuf: bool", "[charbuf]") {
     charbuf cb;
     REQUIRE( (cb.reset() << false).view() == "0" );
@@ -63,4 +128,170 @@ TEST_CASE("charbuf: copy_n vs memcpy", "[!benchmark][charbuf]") {
     BENCHMARK("std::memcpy") {
         std::memcpy(dst.data(), src.data(), src.capacity());
     };
-}
\ No newline at end of file
+}
+
+TEST_CASE("charbuf: arena resource", "[charbuf]") {
+    char storage[128];
+    arena_charbuf_resource mem(storage, sizeof(storage));
+    {
+        charbuf cb(mem);
+        cb << "0123456789";
+        REQUIRE( cb.data() == storage );
+        cb << fill('x', 100); // grows in place
+        REQUIRE( cb.data() == storage );
+        REQUIRE( cb.capacity() == 128 );
+        cb << fill('y', 100); // doesn't fit into arena - falls back to heap
+        REQUIRE( cb.data() != storage );
+        REQUIRE( cb.view() == "0123456789" + std::string(100, 'x') + std::string(100, 'y') );
+        REQUIRE( mem.used() == 0 );
+    }
+    {
+        charbuf a(mem, 16), b(mem, 16);
+        REQUIRE( mem.used() == 64 );
+        a << "abc";
+        b << "def";
+        REQUIRE( a.view() == "abc" );
+        REQUIRE( b.view() == "def" );
+    }
+    mem.reset();
+    REQUIRE( mem.used() == 0 );
+
+    arena_charbuf_resource owned(256);
+    REQUIRE( owned.capacity() == 256 );
+    charbuf cb(owned, 16);
+    cb << "abc";
+    REQUIRE( cb.view() == "abc" );
+    REQUIRE( owned.used() != 0 );
+    volatile std::size_t huge = std::numeric_limits<std::size_t>::max() / 2;
+    REQUIRE_THROWS_AS( arena_charbuf_resource(huge), std::bad_alloc );
+}
+
+TEST_CASE("charbuf: pmr resource", "[charbuf]") {
+    std::pmr::monotonic_buffer_resource upstream;
+    pmr_charbuf_resource mem(&upstream);
+    charbuf cb(mem);
+    cb << std::string(1000, 'a') << 123;
+    REQUIRE( cb.resource() == &mem );
+    REQUIRE( cb.view() == std::string(1000, 'a') + "123" );
+
+    charbuf mv = std::move(cb);
+    REQUIRE( mv.resource() == &mem );
+    REQUIRE( mv.size() == 1003 );
+}
+
+TEST_CASE("charbuf: growth strategies", "[charbuf]") {
+    charbuf pow2(100);
+    REQUIRE( pow2.capacity() == 128 );
+
+    charbuf exact(100, charbuf_policy { .growth = GROW_EXACT });
+    REQUIRE( exact.capacity() == 100 );
+    exact << std::string(101, 'a');
+    REQUIRE( exact.capacity() == 101 );
+
+    charbuf x15(100, charbuf_policy { .growth = GROW_1_5X });
+    REQUIRE( x15.capacity() == 100 );
+    x15 << std::string(101, 'a');
+    REQUIRE( x15.capacity() == 150 );
+    x15 << std::string(200, 'b');
+    REQUIRE( x15.capacity() == 301 );
+    REQUIRE( x15.view() == std::string(101, 'a') + std::string(200, 'b') );
+}
+
+TEST_CASE("charbuf: max capacity", "[charbuf]") {
+    charbuf cb(16, charbuf_policy { .max_capacity = 100 });
+    cb << std::string(90, 'a');
+    REQUIRE( cb.capacity() == 100 ); // pow2 rounding is clamped
+    cb << std::string(10, 'b');
+    REQUIRE_THROWS_AS( cb << 'c', std::length_error );
+    REQUIRE( cb.size() == 100 );
+}
+
+TEST_CASE("charbuf: shrink", "[charbuf]") {
+    charbuf cb(4096);
+    cb << "abc";
+    cb.shrink_to(0);
+    REQUIRE( cb.capacity() == 32 );
+    REQUIRE( cb.view() == "abc" );
+    cb.shrink_to(1000); // never grows
+    REQUIRE( cb.capacity() == 32 );
+}
+
+TEST_CASE("charbuf: decay", "[charbuf]") {
+    charbuf cb(16, charbuf_policy { .decay_frames = 3 });
+    cb << std::string(10000, 'x'); // huge frame
+    REQUIRE( cb.flush().size() == 10000 );
+    REQUIRE( cb.capacity() == 16384 );
+
+    cb << std::string(100, 'a');
+    REQUIRE( cb.flush().size() == 100 );
+    cb << std::string(300, 'b');
+    cb.reset();
+    REQUIRE( cb.capacity() == 16384 );
+
+    cb << std::string(200, 'c');
+    REQUIRE( cb.flush() == std::string(200, 'c') ); // data survives shrink
+    REQUIRE( cb.capacity() == 512 ); // fits the largest small frame
+
+    // large frame restarts counting
+    cb << std::string(20, 'a');
+    cb.reset();
+    cb << std::string(500, 'a');
+    cb.reset();
+    cb << std::string(20, 'a');
+    cb.reset();
+    REQUIRE( cb.capacity() == 512 );
+}
+
+TEST_CASE("charbuf: resource benchmark", "[!benchmark][charbuf]") {
+    arena_charbuf_resource arena(4096);
+    BENCHMARK("malloc") {
+        return (charbuf() << "can't init: " << 12345 << ';' << 678).size();
+    };
+    BENCHMARK("arena") {
+        arena.reset();
+        return (charbuf(arena) << "can't init: " << 12345 << ';' << 678).size();
+    };
+    BENCHMARK("stack") {
+        char storage[64];
+        arena_charbuf_resource mem(storage, sizeof(storage));
+        return (charbuf(mem) << "can't init: " << 12345 << ';' << 678).size();
+    };
+}
+
+TEST_CASE("charbuf: mmap resource", "[charbuf]") {
+    mmap_charbuf_resource mem(8192, 65536);
+    std::string expected;
+    {
+        charbuf cb(mem);
+        for (int i = 0; i < 20000; ++i) {
+            cb << i << ';';
+            expected += std::to_string(i) + ';';
+        }
+        REQUIRE( cb.capacity() >= 65536 ); // crossed both thresholds
+        REQUIRE( cb.view() == expected );
+
+        cb.reset() << "small";
+        cb.shrink_to(0); // back to heap block
+        REQUIRE( cb.capacity() < 8192 );
+        REQUIRE( cb.view() == "small" );
+
+        charbuf mv = std::move(cb);
+        mv << std::string(100000, 'x');
+        REQUIRE( mv.view() == "small" + std::string(100000, 'x') );
+    }
+}
+
+TEST_CASE("charbuf: large growth benchmark", "[!benchmark][charbuf]") {
+    mmap_charbuf_resource mem;
+    const std::string chunk(4096, 'x');
+    BENCHMARK("realloc 64MiB") {
+        charbuf cb;
+        for (int i = 0; i < 16384; ++i) cb << chunk;
+        return cb.size();
+    };
+    BENCHMARK("mmap 64MiB") {
+        charbuf cb(mem);
+        for (int i = 0; i < 16384; ++i) cb << chunk;
+        return cb.size();
+    };
+}
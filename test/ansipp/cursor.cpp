@@ -1,6 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/benchmark/catch_benchmark_all.hpp>
 #include <ansipp/cursor.hpp>
+#include <ansipp/terminal.hpp>
+#include <ansipp/attrs.hpp>
+#include <sstream>
 
 using namespace ansipp;
 
@@ -19,3 +22,19 @@ TEST_CASE("cursor: position escapes") {
     REQUIRE( restore_cursor == "\33" "8" );
 }
 
+
+TEST_CASE("cursor: sized escapes", "[cursor]") {
+    REQUIRE( esc_str(move(CURSOR_TO_COLUMN, 1)) == "\r" );
+    REQUIRE( esc_str(move_rel(-3, 2)) == "\33" "[3D" "\33" "[2B" );
+    REQUIRE( esc_str(move_abs(1, 1)) == "\33" "[H" );
+    REQUIRE( esc_str(move_abs(100000, 2000)) == "\33" "[2000;100000H" );
+    REQUIRE( esc_str(erase(LINE, ALL)) == "\33" "[2K" );
+
+    charbuf cb;
+    cb.write(move_abs(3, 2), erase(LINE, TO_END), attrs().fg(RED), cursor_visibility.off());
+    REQUIRE( cb.view() == "\33" "[2;3H" "\33" "[K" "\33" "[31m" "\33" "[?25l" );
+
+    std::ostringstream os;
+    os << move_abs(3, 2) << attrs().bg(rgb(1, 2, 3));
+    REQUIRE( os.str() == "\33" "[2;3H" "\33" "[48;2;1;2;3m" );
+}
@@ -10,9 +10,11 @@
 #include <string>
 #include <sstream>
 #include <charconv>
+#include <limits>
 
 #include <ansipp/cursor.hpp>
 #include <ansipp/charbuf.hpp>
+#include <ansipp/format.hpp>
 
 using namespace ansipp;
 
@@ -64,7 +66,7 @@ struct format_benchmark {
     }
 
     std::string snprintf_shared() {
-        int len = snprintf(buf, sizeof(buf), "%s%u;%uH", csi.c_str(), y, x);
+        int len = snprintf(buf, sizeof(buf), "%.*s%u;%uH", static_cast<int>(csi.size()), csi.data(), y, x);
         return std::string(buf, len);
     }
 
@@ -89,6 +91,11 @@ struct format_benchmark {
         return std::string(buf, ptr);
     }
 
+    std::string ansipp_format_shared() {
+        ansipp::format<"{}{};{}H">(shared_cb.reset(), csi, y, x);
+        return shared_cb.str();
+    }
+
     std::string current_impl() {
         shared_cb.reset() << move_abs(x, y);
         return shared_cb.str();
@@ -96,6 +103,17 @@ struct format_benchmark {
 
 };
 
+TEST_CASE("format: compile-time format string", "[format]") {
+    charbuf cb;
+    REQUIRE( ansipp::format<"{};{}H">(cb, 10, -5).view() == "10;-5H" );
+    REQUIRE( ansipp::format<"no args">(cb.reset()).view() == "no args" );
+    REQUIRE( ansipp::format<"{{{}}}">(cb.reset(), 'x').view() == "{x}" );
+    REQUIRE( ansipp::format<"{}{}{}">(cb.reset(), "a", std::string_view("bc"), true).view() == "abc1" );
+    REQUIRE( ansipp::format<"[{}m">(cb.reset(), small_uint(38)).view() == "[38m" );
+    REQUIRE( ansipp::format<"{}|{}">(cb.reset(), std::numeric_limits<long long>::min(), std::numeric_limits<unsigned long long>::max()).view()
+        == std::to_string(std::numeric_limits<long long>::min()) + '|' + std::to_string(std::numeric_limits<unsigned long long>::max()) );
+}
+
 // Main benchmark for escape codes format decisions
 // it compares different formatting methods
 TEST_CASE("format: benchmark", "[format][!benchmark]") {
@@ -114,6 +132,7 @@ TEST_CASE("format: benchmark", "[format][!benchmark]") {
     REQUIRE( fb.std_to_chars() == fb.expected_esc );
     REQUIRE( fb.charbuf_alloc() == fb.expected_esc );
     REQUIRE( fb.charbuf_shared() == fb.expected_esc );
+    REQUIRE( fb.ansipp_format_shared() == fb.expected_esc );
     REQUIRE( fb.current_impl() == fb.expected_esc ); 
 
 #if defined(__cpp_lib_format_ranges) || defined(__cpp_lib_format)
@@ -128,6 +147,7 @@ TEST_CASE("format: benchmark", "[format][!benchmark]") {
     BENCHMARK("std_to_chars") { return fb.std_to_chars(); };
     BENCHMARK("charbuf") { return fb.charbuf_alloc(); };
     BENCHMARK("charbuf_shared") { return fb.charbuf_shared(); };
+    BENCHMARK("ansipp_format_shared") { return fb.ansipp_format_shared(); };
     BENCHMARK("current_impl") { return fb.current_impl(); };
 
 }
@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+
+#include <string>
+#include <vector>
+#include <ansipp/frame.hpp>
+#include <ansipp/cursor.hpp>
+#include <ansipp/attrs.hpp>
+
+using namespace ansipp;
+
+TEST_CASE("frame: segment shares recorded buffer", "[frame]") {
+    charbuf buf(64);
+    buf << "header";
+    const char* data = buf.data();
+    shared_segment s(std::move(buf));
+    REQUIRE( s.view() == "header" );
+    REQUIRE( s.data() == data ); // not copied
+
+    shared_segment copy = s;
+    REQUIRE( copy.data() == data );
+    REQUIRE( copy.size() == 6 );
+
+    REQUIRE( shared_segment().empty() );
+    REQUIRE( shared_segment("abc").view() == "abc" );
+    REQUIRE( record_segment([](charbuf& out) { out << "x=" << 42; }).view() == "x=42" );
+}
+
+TEST_CASE("frame: splicing", "[frame]") {
+    const shared_segment big(std::string(200, '#'));
+    const shared_segment small("--");
+    frame_builder f(64, 16);
+
+    f << "a" << big << big << "bc" << small << 7 << big;
+    REQUIRE( f.buffer().view() == "abc--7" ); // small segment is inlined
+    REQUIRE( f.splice_count() == 3 );
+    REQUIRE( f.size() == 1 + 200 + 200 + 2 + 2 + 1 + 200 );
+    REQUIRE( f.str() == "a" + std::string(400, '#') + "bc--7" + std::string(200, '#') );
+
+    const std::vector<std::string_view>& parts = f.parts();
+    REQUIRE( parts.size() == 5 ); // no empty range between adjacent segments and after the last one
+    REQUIRE( parts[0] == "a" );
+    REQUIRE( parts[1].data() == big.data() );
+    REQUIRE( parts[2].data() == big.data() );
+    REQUIRE( parts[3] == "bc--7" );
+    REQUIRE( parts[4].data() == big.data() );
+
+    f.reset();
+    REQUIRE( f.size() == 0 );
+    REQUIRE( f.splice_count() == 0 );
+    REQUIRE( f.parts().empty() );
+
+    f << big << move(CURSOR_UP, 2);
+    REQUIRE( f.parts().size() == 2 );
+    REQUIRE( f.str() == std::string(big.view()) + "\x1b[2A" );
+}
+
+TEST_CASE("frame: segment outlives its frame", "[frame]") {
+    frame_builder f(64, 0);
+    {
+        shared_segment s(std::string(32, '*'));
+        f << s << "!";
+    }
+    REQUIRE( f.str() == std::string(32, '*') + "!" );
+}
+
+TEST_CASE("frame: format vs splice", "[frame][!benchmark]") {
+    constexpr int rows = 40;
+    auto draw_chrome = [](charbuf& out) {
+        out << attrs().bg(WHITE).fg(BLACK) << " press q to exit, <arrows> to move " << fill(' ', 86);
+        for (int y = 0; y < rows; y++) out << move(CURSOR_DOWN_START) << ' ' << move(CURSOR_TO_COLUMN, 122) << ' ';
+        out << attrs();
+    };
+    const shared_segment chrome = record_segment(draw_chrome, 1024);
+    charbuf out(4096);
+    frame_builder f(4096);
+
+    BENCHMARK("format") {
+        draw_chrome(out);
+        out << "frame=" << 42;
+        return out.flush().size();
+    };
+    BENCHMARK("splice") {
+        f << chrome << "frame=" << 42;
+        const std::size_t n = f.parts().size();
+        f.reset();
+        return n;
+    };
+}
@@ -83,6 +83,14 @@ TEST_CASE("integral: ichars_lookup", "[integral]") {
     REQUIRE( std::string_view(t.chars[14], t.chars[14] + digits) == "1110" );
 }
 
+TEST_CASE("integral: u10small", "[integral]") {
+    for (unsigned int v = 0; v < 1000; ++v) {
+        char buf[4];
+        const char* end = u10small(buf, v);
+        REQUIRE( std::string_view(buf, end) == std::to_string(v) );
+    }
+}
+
 TEST_CASE("integral: iabs", "[integral]") {
     std::intmax_t v = std::numeric_limits<std::intmax_t>::max();
     REQUIRE( iabs(v) == static_cast<std::uintmax_t>(v) );
@@ -245,6 +253,32 @@ TEST_CASE("integral: ichars", "[integral]") {
     REQUIRE(to_chars_str == ichars_str);
 }
 
+TEST_CASE("integral: swar8", "[integral]") {
+    char buf[8];
+    store8(buf, swar8(12345678));
+    REQUIRE(std::string_view(buf, 8) == "12345678");
+    store8(buf, swar8(0));
+    REQUIRE(std::string_view(buf, 8) == "00000000");
+    store8(buf, swar8(99999999));
+    REQUIRE(std::string_view(buf, 8) == "99999999");
+}
+
+TEST_CASE("integral: uswarchars", "[integral]") {
+    const auto [digits, value] = GENERATE(pow_gen<unsigned long long>::wrap(10));
+    for (unsigned long long v: { value - 1, value, value + 1, value * 9 / 7 }) {
+        char buf[32], expected[32];
+        const unsigned int len = ulen(v, 10);
+        std::string_view to_chars_str(expected, std::to_chars(expected, expected + sizeof(expected), v).ptr);
+        
+        uswarchars(buf, len, v);
+        REQUIRE(std::string_view(buf, len) == to_chars_str);
+#ifdef ANSIPP_FAST_INTEGRAL_SSE2
+        usse2chars(buf, len, v);
+        REQUIRE(std::string_view(buf, len) == to_chars_str);
+#endif
+    }
+}
+
 template <std::unsigned_integral T>
 void uchars_digit_str(char* buf, unsigned int length, T value, unsigned int base) {
     static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
@@ -281,6 +315,18 @@ TEST_CASE("integral: uchars benchmark", "[integral][!benchmark]") {
             ulookupchars<base, 2>(buf, len, value);
             return std::string_view(buf, buf + len);
         };
+        BENCHMARK("uswarchars") {
+            unsigned int len = ulen(value, base);
+            uswarchars(buf, len, value);
+            return std::string_view(buf, buf + len);
+        };
+#ifdef ANSIPP_FAST_INTEGRAL_SSE2
+        BENCHMARK("usse2chars") {
+            unsigned int len = ulen(value, base);
+            usse2chars(buf, len, value);
+            return std::string_view(buf, buf + len);
+        };
+#endif
         BENCHMARK("std::to_string") {
             return std::to_string(value);
         };
@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <ansipp/record.hpp>
+#include <ansipp/error.hpp>
+
+using namespace ansipp;
+
+namespace {
+
+std::string escape(std::string_view data) {
+    charbuf out;
+    std::string carry;
+    json_escape(out, data, carry);
+    REQUIRE( carry.empty() );
+    return out.str();
+}
+
+std::string unescape(std::string_view json) {
+    std::string out;
+    REQUIRE( json_unescape(json, 0, out) == json.size() );
+    return out;
+}
+
+}
+
+TEST_CASE("record: json strings", "[record]") {
+    REQUIRE( escape("plain text") == "plain text" );
+    REQUIRE( escape("\x1b[31m\"q\"\\\r\n") == "\\u001b[31m\\\"q\\\"\\\\\\r\\n" );
+    REQUIRE( escape("\xe2\x96\x88 block") == "\xe2\x96\x88 block" );
+    REQUIRE( escape("\xff") == "\\u00ff" ); // not UTF-8
+
+    for (std::string_view s: { "", "plain", "\x1b[1;2H\x7f\t", "\xe2\x96\x88\xf0\x9f\x90\x8d" }) {
+        REQUIRE( unescape("\"" + escape(s) + "\"") == s );
+    }
+    REQUIRE( unescape("\"\\ud83d\\udc0d\\/\"") == "\xf0\x9f\x90\x8d/" );
+
+    std::string out;
+    REQUIRE( json_unescape("\"unterminated", 0, out) == std::string_view::npos );
+    REQUIRE( json_unescape("\"bad \\x\"", 0, out) == std::string_view::npos );
+}
+
+TEST_CASE("record: split utf8 sequence", "[record]") {
+    charbuf out;
+    std::string carry;
+    json_escape(out, "a\xe2\x96", carry);
+    REQUIRE( out.str() == "a" );
+    REQUIRE( carry == "\xe2\x96" );
+    json_escape(out, "\x88" "b", carry);
+    REQUIRE( out.str() == "a\xe2\x96\x88" "b" );
+    REQUIRE( carry.empty() );
+}
+
+TEST_CASE("record: events", "[record]") {
+    asciicast_event e;
+    REQUIRE( asciicast_reader::parse_event("[1.5, \"o\", \"\\u001b[H\"]", e) );
+    REQUIRE( e.time == 1.5 );
+    REQUIRE( e.type == 'o' );
+    REQUIRE( e.data == "\x1b[H" );
+    REQUIRE( asciicast_reader::parse_event("[0.25,\"i\",\"q\"]\n", e) );
+    REQUIRE( e.type == 'i' );
+    REQUIRE( !asciicast_reader::parse_event("{\"version\": 2}", e) );
+    REQUIRE( !asciicast_reader::parse_event("[1, \"o\", \"x\"", e) );
+}
+
+TEST_CASE("record: recorder and reader", "[record]") {
+    const std::string path = (std::filesystem::temp_directory_path() / "ansipp_record_test.cast").string();
+    {
+        std::error_code ec;
+        asciicast_recorder rec;
+        rec.start(ec, path, vec(80, 24));
+        REQUIRE( !ec );
+        REQUIRE( rec.recording() );
+        rec.start(ec, path, vec(80, 24));
+        REQUIRE( ec == ansipp_error::already_initialized );
+
+        // events are passed directly, test output must not go to terminal
+        rec.on_io(IO_OUTPUT, "\x1b[2J\xe2\x96");
+        rec.on_io(IO_INPUT, "q"); // input isn't recorded
+        rec.on_io(IO_OUTPUT, "\x88\n");
+        const std::string_view parts[] = { "ab", "", "c" };
+        rec.on_io_parts(IO_OUTPUT, parts); // gather write is single event
+        rec.stop();
+        REQUIRE( !rec.recording() );
+    }
+
+    std::error_code ec;
+    asciicast_reader reader;
+    reader.open(ec, path);
+    REQUIRE( !ec );
+    REQUIRE( reader.size == vec(80, 24) );
+
+    std::string replayed;
+    double last = 0;
+    int events = 0;
+    for (asciicast_event e; reader.next(e); ++events) {
+        REQUIRE( e.type == 'o' );
+        REQUIRE( e.time >= last );
+        last = e.time;
+        replayed += e.data;
+    }
+    REQUIRE( events == 3 );
+    REQUIRE( replayed == "\x1b[2J\xe2\x96\x88\nabc" );
+    std::filesystem::remove(path);
+}
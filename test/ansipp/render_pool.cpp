@@ -0,0 +1,56 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators_all.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#include <ansipp/render_pool.hpp>
+#include <ansipp/cursor.hpp>
+
+using namespace ansipp;
+
+std::string render_rows_serial(int rows) {
+    charbuf out;
+    for (int y = 0; y < rows; ++y) out << move_abs(1, y + 1) << "row " << y;
+    return out.str();
+}
+
+TEST_CASE("render_pool: rows order", "[render_pool]") {
+    const unsigned int threads = GENERATE(1U, 2U, 3U, 8U);
+    const int rows = GENERATE(0, 1, 5, 120);
+    render_pool pool(threads);
+    REQUIRE( pool.thread_count() == threads );
+
+    charbuf out;
+    pool.render(rows, [](charbuf& o, int y) { o << move_abs(1, y + 1) << "row " << y; }).append_to(out);
+    REQUIRE( out.view() == render_rows_serial(rows) );
+
+    // pool must be reusable for next frames
+    out.reset();
+    pool.render(rows, [](charbuf& o, int y) { o << move_abs(1, y + 1) << "row " << y; }).append_to(out);
+    REQUIRE( out.view() == render_rows_serial(rows) );
+}
+
+TEST_CASE("render_pool: row_fn throws", "[render_pool]") {
+    const unsigned int threads = GENERATE(1U, 2U, 4U);
+    const int failing_row = GENERATE(0, 99); // first range is rendered by calling thread, the last one by worker
+    render_pool pool(threads);
+
+    std::atomic<int> rendered = 0;
+    auto row_fn = [&](charbuf& o, int y) {
+        if (y == failing_row) throw std::runtime_error("row " + std::to_string(y));
+        o << "row " << y;
+        ++rendered;
+    };
+    REQUIRE_THROWS_WITH( pool.render(100, row_fn), "row " + std::to_string(failing_row) );
+    REQUIRE( pool.view().size() == threads );
+    for (std::string_view chunk: pool.view()) REQUIRE( chunk.empty() ); // partial frame is dropped
+    const int rendered_before = rendered.load();
+
+    // every thread is done with `row_fn` once render returns, pool is reusable
+    charbuf out;
+    pool.render(3, [](charbuf& o, int y) { o << move_abs(1, y + 1) << "row " << y; }).append_to(out);
+    REQUIRE( out.view() == render_rows_serial(3) );
+    REQUIRE( rendered.load() == rendered_before );
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <ansipp/session.hpp>
+#include <ansipp/attrs.hpp>
+
+using namespace ansipp;
+
+TEST_CASE("session: select", "[session]") {
+    config cfg;
+    cfg.mouse_encoding = MOUSE_LEGACY;
+
+    // nothing confirmed: defaults
+    terminal_caps caps;
+    caps.mouse_sgr = true;
+    session s = session::select(caps, cfg);
+    REQUIRE( s.truecolor );
+    REQUIRE( !s.rep );
+    REQUIRE( !s.ech );
+    REQUIRE( s.mouse_encoding == MOUSE_LEGACY );
+
+    caps.answered = true;
+    caps.da1_class = 1;
+    s = session::select(caps, cfg);
+    REQUIRE( !s.truecolor ); // VT100 class terminal
+    REQUIRE( !s.ech );
+    REQUIRE( s.mouse_encoding == MOUSE_SGR );
+
+    // unknown terminal without `COLORTERM` (i.e. over ssh): truecolor isn't confirmed, but not ruled out either
+    caps.da1_class = 62;
+    caps.version.clear();
+    s = session::select(caps, cfg);
+    REQUIRE( s.truecolor );
+    REQUIRE( s.ech );
+
+    caps.da1_class = 65;
+    caps.truecolor = true;
+    caps.synchronized_output = true;
+    caps.version = "XTerm(390)";
+    s = session::select(caps, cfg);
+    REQUIRE( s.truecolor );
+    REQUIRE( s.ech );
+    REQUIRE( s.rep );
+    REQUIRE( s.synchronized_output );
+}
+
+TEST_CASE("session: rgb to 256 colors", "[session]") {
+    REQUIRE( rgb(0, 0, 0).to_256() == 16 );
+    REQUIRE( rgb(255, 255, 255).to_256() == 231 );
+    REQUIRE( rgb(255, 0, 0).to_256() == 196 );
+    REQUIRE( rgb(95, 135, 175).to_256() == 67 );
+    REQUIRE( rgb(128, 128, 128).to_256() == 244 );
+    REQUIRE( rgb(8, 8, 8).to_256() == 232 );
+
+    session s;
+    s.truecolor = false;
+    set_session(s);
+    REQUIRE( esc_str(attrs().fg(rgb(255, 0, 0)).bg(rgb(0, 0, 0))) == "\33[38;5;196;48;5;16m" );
+    set_session(session {});
+    REQUIRE( esc_str(attrs().fg(rgb(255, 0, 0))) == "\33[38;2;255;0;0m" );
+}
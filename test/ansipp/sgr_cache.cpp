@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+
+#include <string>
+#include <ansipp/sgr_cache.hpp>
+
+using namespace ansipp;
+
+TEST_CASE("sgr_cache: lookup", "[sgr_cache]") {
+    sgr_cache cache(64);
+    REQUIRE( cache.capacity() == 64 );
+    REQUIRE( cache.size() == 0 );
+
+    const packed_attrs red = packed_attrs().fg(RED);
+    REQUIRE( cache.get(red).view() == "\33[31m" );
+    REQUIRE( cache.misses() == 1 );
+    REQUIRE( cache.get(red).view() == "\33[31m" );
+    REQUIRE( cache.get(packed_attrs()).view() == "\33[m" ); // zero key is a valid key
+    REQUIRE( cache.get(packed_attrs()).view() == "\33[m" );
+    REQUIRE( cache.hits() == 2 );
+    REQUIRE( cache.misses() == 2 );
+    REQUIRE( cache.size() == 2 );
+
+    for (int v = 0; v < 256; ++v) {
+        const packed_attrs a = packed_attrs().fg(rgb(v, 0, 0)).bg(static_cast<unsigned char>(v));
+        REQUIRE( cache.get(a).view() == esc_str(a) );
+    }
+    REQUIRE( cache.size() <= cache.capacity() );
+    REQUIRE( cache.evictions() == cache.misses() - cache.size() );
+
+    cache.clear();
+    REQUIRE( cache.size() == 0 );
+}
+
+TEST_CASE("sgr_cache: lru eviction", "[sgr_cache]") {
+    sgr_cache cache(sgr_cache::ways); // single set
+    for (unsigned char i = 0; i < sgr_cache::ways; ++i) cache.get(packed_attrs().fg(i));
+    cache.get(packed_attrs().fg(static_cast<unsigned char>(0))); // refresh the oldest one
+    cache.get(packed_attrs().fg(static_cast<unsigned char>(100))); // evicts fg(1)
+    REQUIRE( cache.evictions() == 1 );
+
+    const std::uint64_t misses = cache.misses();
+    cache.get(packed_attrs().fg(static_cast<unsigned char>(0)));
+    cache.get(packed_attrs().fg(static_cast<unsigned char>(2)));
+    REQUIRE( cache.misses() == misses );
+    cache.get(packed_attrs().fg(static_cast<unsigned char>(1)));
+    REQUIRE( cache.misses() == misses + 1 );
+}
+
+TEST_CASE("sgr_cache: session change", "[sgr_cache]") {
+    sgr_cache cache;
+    const packed_attrs a = packed_attrs().fg(rgb(255, 0, 0));
+    REQUIRE( cache.get(a).view() == "\33[38;2;255;0;0m" );
+    session s;
+    s.truecolor = false;
+    set_session(s);
+    REQUIRE( cache.get(a).view() == "\33[38;5;196m" );
+    set_session(session {});
+    REQUIRE( cache.get(a).view() == "\33[38;2;255;0;0m" );
+}
+
+TEST_CASE("sgr_cache: format vs cache", "[sgr_cache][!benchmark]") {
+    sgr_cache cache;
+    charbuf out(1 << 16);
+    BENCHMARK("attrs") {
+        for (int v = 0; v < 64; ++v) out << attrs().on(BOLD).fg(rgb(v * 4, 255 - v * 4, 128)).bg(rgb(0x20, 0x20, 0x20)) << 'x';
+        return out.flush().size();
+    };
+    BENCHMARK("packed_attrs") {
+        for (int v = 0; v < 64; ++v) out << packed_attrs().on(BOLD).fg(rgb(v * 4, 255 - v * 4, 128)).bg(rgb(0x20, 0x20, 0x20)) << 'x';
+        return out.flush().size();
+    };
+    BENCHMARK("sgr_cache") {
+        for (int v = 0; v < 64; ++v) out << cache.get(packed_attrs().on(BOLD).fg(rgb(v * 4, 255 - v * 4, 128)).bg(rgb(0x20, 0x20, 0x20))) << 'x';
+        return out.flush().size();
+    };
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <ansipp/sink.hpp>
+#include <ansipp/io.hpp>
+
+#include "capture.hpp"
+
+#ifndef _WIN32
+
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+
+using namespace ansipp;
+
+TEST_CASE("sink: gather write of many parts", "[sink]") {
+    // more parts than single writev takes, large enough to fill pipe many times
+    std::vector<std::string> storage;
+    std::vector<std::string_view> parts;
+    std::string expected;
+    for (int i = 0; i < 300; ++i) {
+        storage.push_back(std::to_string(i) + std::string(static_cast<std::size_t>(i * 97 % 8000), static_cast<char>('a' + i % 26)) + "\n");
+    }
+    for (const std::string& s: storage) {
+        parts.push_back(s);
+        expected += s;
+    }
+
+    // writer is interrupted by signal without SA_RESTART, so writev returns partial writes which must be resumed
+    struct sigaction sa = {}, old_sa;
+    sa.sa_handler = [](int) {};
+    sigaction(SIGUSR1, &sa, &old_sa);
+
+    stdout_capture capture;
+    std::atomic_bool done = false;
+    const pthread_t writer = pthread_self();
+    std::thread interrupter([&] {
+        while (!done.load()) {
+            pthread_kill(writer, SIGUSR1);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    const std::streamsize w = stdout_write(std::span<const std::string_view>(parts));
+    done = true;
+    interrupter.join();
+    const std::string written = capture.finish();
+    sigaction(SIGUSR1, &old_sa, nullptr);
+
+    REQUIRE( w == static_cast<std::streamsize>(expected.size()) );
+    REQUIRE( written == expected );
+}
+
+TEST_CASE("sink: multiple producers", "[sink]") {
+    constexpr int threads = 4;
+    constexpr int segments = 2000;
+
+    stdout_capture capture;
+    {
+        output_sink sink;
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&sink, t] {
+                for (int i = 0; i < segments; ++i) {
+                    // every segment is a line, segments of one thread must be written in order
+                    output_sink::local() << 't' << t << ':' << i << ':' << std::string_view("xxxxxxxxxxxxxxxx", static_cast<std::size_t>(i % 17)) << '\n';
+                    sink.submit();
+                }
+                sink.flush();
+            });
+        }
+        for (std::thread& p: producers) p.join();
+    } // destructor writes everything submitted
+    const std::string written = capture.finish();
+
+    int next[threads] = {};
+    int lines = 0;
+    for (std::size_t pos = 0; pos < written.size(); ++lines) {
+        const std::size_t end = written.find('\n', pos);
+        REQUIRE( end != std::string::npos );
+        const std::string_view line(written.data() + pos, end - pos);
+        pos = end + 1;
+
+        REQUIRE( line.size() >= 4 );
+        REQUIRE( line[0] == 't' );
+        const int t = line[1] - '0';
+        REQUIRE( (t >= 0 && t < threads) );
+        const std::size_t colon = line.find(':', 3);
+        REQUIRE( colon != std::string_view::npos );
+        const int i = std::stoi(std::string(line.substr(3, colon - 3)));
+        REQUIRE( i == next[t] );
+        REQUIRE( line.substr(colon + 1) == std::string(static_cast<std::size_t>(i % 17), 'x') );
+        ++next[t];
+    }
+    REQUIRE( lines == threads * segments );
+}
+
+TEST_CASE("sink: write error is reported", "[sink]") {
+    // reader is gone: writes fail with `EPIPE` (`SIGPIPE` is ignored)
+    struct sigaction sa = {}, old_sa;
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, &old_sa);
+    int fds[2];
+    REQUIRE( pipe(fds) == 0 );
+    close(fds[0]);
+    {
+        stdout_capture capture(fds[1]);
+        output_sink sink;
+        REQUIRE( !sink.flush() );
+        sink.submit("lost");
+        const std::error_code ec = sink.flush();
+        REQUIRE( ec == std::errc::broken_pipe );
+        sink.submit("also lost");
+        REQUIRE( sink.flush() == ec ); // sticky
+        REQUIRE( sink.error() == ec );
+    }
+    sigaction(SIGPIPE, &old_sa, nullptr);
+}
+
+#endif
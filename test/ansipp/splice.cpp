@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <string>
+
+#include <ansipp/splice.hpp>
+
+#include "capture.hpp"
+
+#ifndef _WIN32
+
+#include <unistd.h>
+
+using namespace ansipp;
+
+TEST_CASE("splice: regular file fallback", "[splice]") {
+    std::FILE* f = std::tmpfile();
+    REQUIRE( f != nullptr );
+    std::string written;
+    {
+        stdout_capture capture(dup(fileno(f)));
+        {
+            splice_output out(4096, true);
+            REQUIRE( !out.is_spliced() );
+            out.buffer() << "first " << 1;
+            REQUIRE( out.flush() == 7 );
+            out.buffer() << " second"; // flushed by destructor
+        }
+        capture.finish();
+    }
+    std::rewind(f);
+    for (int c; (c = std::fgetc(f)) != EOF;) written.push_back(static_cast<char>(c));
+    std::fclose(f);
+    REQUIRE( written == "first 1 second" );
+}
+
+TEST_CASE("splice: pipe round trip wraps ring", "[splice]") {
+    std::string expected;
+    stdout_capture capture;
+    {
+        // single page window, ring is window plus pipe capacity, so it's wrapped many times
+        splice_output out(4096, true);
+#ifdef __linux__
+        REQUIRE( out.is_spliced() );
+#endif
+        for (int i = 0; i < 2000; ++i) {
+            const std::string line = std::to_string(i) + std::string(static_cast<std::size_t>(i % 300), static_cast<char>('a' + i % 26)) + "\n";
+            if (out.buffer().available() < line.size()) out.flush();
+            out.buffer() << line;
+            REQUIRE( !out.buffer().overflow() );
+            expected += line;
+        }
+    }
+    REQUIRE( capture.finish() == expected );
+}
+
+TEST_CASE("splice: vmsplice is opt-in", "[splice]") {
+    stdout_capture capture;
+    {
+        splice_output out(4096);
+        REQUIRE( !out.is_spliced() ); // reader may move pages further or enlarge pipe
+        out.buffer() << "copied";
+    }
+    REQUIRE( capture.finish() == "copied" );
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <numbers>
+#include <string>
+
+#include <ansipp/static_charbuf.hpp>
+#include <ansipp/attrs.hpp>
+#include <ansipp/cursor.hpp>
+
+using namespace ansipp;
+
+TEST_CASE("static_charbuf: format", "[static_charbuf]") {
+    static_charbuf<64> cb;
+    REQUIRE( cb.capacity() == 64 );
+    cb << move_abs(10, 5) << attrs().fg(RED) << -12 << ' ' << 34U << ' ' << true;
+    REQUIRE( cb.view() == "\33" "[5;10H" "\33" "[31m-12 34 1" );
+    REQUIRE( !cb.overflow() );
+    REQUIRE( (cb.reset() << floating_format(std::numbers::pi, std::chars_format::fixed, 2)).view() == "3.14" );
+}
+
+TEST_CASE("static_charbuf: overflow", "[static_charbuf]") {
+    static_charbuf<8> cb;
+    cb << "1234" << "56789" << "0";
+    REQUIRE( cb.overflow() );
+    REQUIRE( cb.view() == "1234" ); // "0" fits, but dropped after first overflow
+    
+    cb.reset() << std::numbers::pi;
+    REQUIRE( cb.overflow() );
+    REQUIRE( cb.view() == "" );
+
+    cb.reset() << "1234" << move_abs(100, 200); // never partially written
+    REQUIRE( cb.overflow() );
+    REQUIRE( cb.view() == "1234" );
+
+    cb.reset() << "12" << move_abs(3, 2); // fits exactly, but less than max_size()
+    REQUIRE( !cb.overflow() );
+    REQUIRE( cb.view() == "12" "\33" "[2;3H" );
+
+    cb.reset() << fill(' ', 8);
+    REQUIRE( !cb.overflow() );
+    REQUIRE( cb.available() == 0 );
+}
+
+TEST_CASE("static_charbuf: escape bound larger than buffer", "[static_charbuf]") {
+    static_charbuf<80> cb;
+    static_assert(packed_attrs::max_size() > 80);
+    cb << packed_attrs().fg(RED);
+    REQUIRE( !cb.overflow() );
+    REQUIRE( cb.view() == "\33" "[31m" );
+
+    attrs many;
+    for (int i = 0; i < 20; ++i) many.fg(RED);
+    REQUIRE( many.max_size() > 64 );
+    cb.reset() << std::string(10, '.') << many;
+    REQUIRE( !cb.overflow() );
+    REQUIRE( cb.size() == 10 + esc_str(many).size() );
+    cb << packed_attrs().bg(BLUE) << packed_attrs().bg(GREEN); // the second one doesn't fit
+    REQUIRE( cb.overflow() );
+    REQUIRE( cb.view().ends_with("\33" "[44m") );
+}
+
+TEST_CASE("static_charbuf: fixed_charbuf", "[static_charbuf]") {
+    char buf[16];
+    fixed_charbuf cb(buf, sizeof(buf));
+    cb << cursor_visibility.off() << integral_format(255U, 16, true);
+    REQUIRE( cb.data() == buf );
+    REQUIRE( cb.view() == "\33" "[?25lFF" );
+    cb.reset() << integral_format(65536U).grouping(',').pad(8);
+    REQUIRE( cb.view() == "  65,536" );
+    cb << integral_format(1U).pad(9);
+    REQUIRE( cb.overflow() );
+    REQUIRE( cb.view() == "  65,536" );
+}
@@ -0,0 +1,24 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <ansipp/charbuf.hpp>
+#include <ansipp/stats.hpp>
+
+using namespace ansipp;
+
+TEST_CASE("stats: charbuf reallocations", "[stats]") {
+    const stats before = get_stats();
+    {
+        charbuf cb(16);
+        for (int i = 0; i < 1000; ++i) cb << "0123456789";
+    }
+    const stats d = get_stats() - before;
+#if ANSIPP_STATS
+    REQUIRE( d.charbuf_reallocs >= 2 );
+    REQUIRE( d.charbuf_realloc_bytes >= 10000 );
+#else
+    REQUIRE( d.charbuf_reallocs == 0 );
+    REQUIRE( get_stats().charbuf_reallocs == 0 );
+#endif
+    reset_stats();
+    REQUIRE( get_stats().write_calls == 0 );
+}
@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <ansipp/charbuf.hpp>
+#include <ansipp/static_charbuf.hpp>
+#include <ansipp/attrs.hpp>
+#include <ansipp/terminal.hpp>
+#include <ansipp/session.hpp>
+
+#include "vt.hpp"
+
+using namespace ansipp;
+
+namespace {
+
+struct session_guard {
+    explicit session_guard(bool rep, bool ech) {
+        session s;
+        s.rep = rep;
+        s.ech = ech;
+        set_session(s);
+    }
+    ~session_guard() { set_session(session {}); }
+};
+
+}
+
+TEST_CASE("terminal: rep and ech escapes", "[terminal]") {
+    REQUIRE( esc_str(repeat_char(1)) == "\33[b" );
+    REQUIRE( esc_str(repeat_char(20)) == "\33[20b" );
+    REQUIRE( esc_str(erase_chars(1)) == "\33[X" );
+    REQUIRE( esc_str(erase_chars(300)) == "\33[300X" );
+}
+
+TEST_CASE("terminal: fill cells", "[terminal]") {
+    // default session: plain characters
+    REQUIRE( esc_str(fill_cells('-', 10)) == "----------" );
+
+    {
+        session_guard g(true, false);
+        REQUIRE( esc_str(fill_cells('-', 5)) == "-----" ); // break-even
+        REQUIRE( esc_str(fill_cells('-', 6)) == "-\33[5b" );
+        REQUIRE( esc_str(fill_cells(' ', 100)) == " \33[99b" );
+        REQUIRE( esc_str(fill_cells('\n', 10)) == std::string(10, '\n') ); // not graphic
+    }
+    {
+        session_guard g(false, true);
+        REQUIRE( esc_str(fill_cells('-', 10)) == "----------" );
+        REQUIRE( esc_str(fill_cells(' ', 8, true)) == "        " );
+        REQUIRE( esc_str(fill_cells(' ', 9, true)) == "\33[9X\33[9C" );
+        REQUIRE( esc_str(fill_cells(' ', 9)) == "         " ); // may end at the right margin
+        REQUIRE( esc_str(text_runs("a         b         ")) == "a\33[9X\33[9Cb         " ); // the last run is never ECH
+    }
+}
+
+TEST_CASE("terminal: runs are written exactly at buffer end", "[terminal]") {
+    // writes must not touch bytes after `max_size()`, guard bytes follow the buffer
+    auto write_at_end = [](auto item) {
+        const std::size_t size = item.max_size();
+        char storage[32];
+        std::memset(storage, '#', sizeof(storage));
+        fixed_charbuf fb(storage, size);
+        fb << item;
+        REQUIRE( !fb.overflow() );
+        REQUIRE( std::string_view(storage + size, sizeof(storage) - size) == std::string(sizeof(storage) - size, '#') );
+        return std::string(fb.view());
+    };
+    {
+        session_guard g(true, false);
+        REQUIRE( write_at_end(fill_cells('-', 6)) == "-\33[5b" );
+        REQUIRE( write_at_end(text_runs("ab------")) == "ab-\33[5b" );
+    }
+    {
+        session_guard g(false, true);
+        REQUIRE( write_at_end(fill_cells(' ', 9, true)) == "\33[9X\33[9C" );
+    }
+
+    session_guard g(true, false);
+    charbuf cb(32);
+    cb << std::string(27, 'x') << fill_cells('-', 6); // ends exactly at capacity
+    REQUIRE( cb.view() == std::string(27, 'x') + "-\33[5b" );
+}
+
+TEST_CASE("terminal: compressed output is equivalent", "[terminal]") {
+    const std::string row = "| name" + std::string(30, ' ') + "|" + std::string(40, '=') + "| x  y |";
+
+    auto render = [&](bool rep, bool ech, vt_screen& vt) {
+        session_guard g(rep, ech);
+        charbuf cb;
+        cb << attrs().bg(BLUE) << text_runs(row) << fill_cells('.', 20) << fill_cells(' ', 10, true) << '#';
+        vt.write(cb.view());
+        return cb.size();
+    };
+
+    vt_screen plain(120, 1), with_rep(120, 1), with_ech(120, 1);
+    const std::size_t plain_size = render(false, false, plain);
+    const std::size_t rep_size = render(true, false, with_rep);
+    const std::size_t ech_size = render(false, true, with_ech);
+
+    REQUIRE( plain.text() == row + std::string(20, '.') + std::string(10, ' ') + "#" );
+    for (int x = 0; x < plain.cols; ++x) {
+        REQUIRE( with_rep.at(x, 0) == plain.at(x, 0) );
+        REQUIRE( with_ech.at(x, 0) == plain.at(x, 0) );
+    }
+    REQUIRE( with_rep.cursor() == plain.cursor() );
+    REQUIRE( with_ech.cursor() == plain.cursor() );
+    REQUIRE( rep_size < ech_size );
+    REQUIRE( ech_size < plain_size );
+}
+
+TEST_CASE("terminal: compressed output is equivalent at the right margin", "[terminal]") {
+    // runs end exactly at the last column and are followed by more text, which must wrap to the next row
+    const std::string row = "| name" + std::string(30, ' ');
+    const int cols = static_cast<int>(row.size());
+
+    auto render = [&](bool rep, bool ech, vt_screen& vt) {
+        session_guard g(rep, ech);
+        charbuf cb;
+        cb << attrs().bg(BLUE) << text_runs(row) << '#' << fill_cells(' ', static_cast<unsigned int>(cols - 1)) << '@';
+        vt.write(cb.view());
+        return cb.size();
+    };
+
+    vt_screen plain(cols, 3), with_rep(cols, 3), with_ech(cols, 3);
+    render(false, false, plain);
+    render(true, false, with_rep);
+    render(false, true, with_ech);
+
+    REQUIRE( plain.text() == "| name\n#\n@" );
+    for (int y = 0; y < plain.rows; ++y) {
+        for (int x = 0; x < plain.cols; ++x) {
+            REQUIRE( with_rep.at(x, y) == plain.at(x, y) );
+            REQUIRE( with_ech.at(x, y) == plain.at(x, y) );
+        }
+    }
+    REQUIRE( with_rep.cursor() == plain.cursor() );
+    REQUIRE( with_ech.cursor() == plain.cursor() );
+}
@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <string>
+#include <ansipp/trace.hpp>
+
+using namespace ansipp;
+
+TEST_CASE("trace: histogram", "[trace]") {
+    latency_histogram h;
+    REQUIRE( h.percentile_ns(0.5) == 0 );
+    h.add(500);         // < 1us
+    h.add(3'000);       // [2, 4) us
+    h.add(3'500);
+    h.add(1'000'000);   // [512, 1024) us
+    REQUIRE( h.count == 4 );
+    REQUIRE( h.buckets[0] == 1 );
+    REQUIRE( h.buckets[2] == 2 );
+    REQUIRE( h.buckets[10] == 1 );
+    REQUIRE( h.max_ns == 1'000'000 );
+    REQUIRE( h.percentile_ns(0) == 1'000 );
+    REQUIRE( h.percentile_ns(0.5) == 4'000 );
+    REQUIRE( h.percentile_ns(1) == 1'000'000 ); // clamped to max
+}
+
+TEST_CASE("trace: input correlation", "[trace]") {
+    latency_tracer t(4);
+    t.record(IO_OUTPUT, 100, 1'000);   // not an answer
+    t.record(IO_INPUT, 1, 10'000);
+    t.record(IO_INPUT, 3, 12'000);
+    t.record(IO_OUTPUT, 50, 20'000);   // answers both inputs
+    t.record(IO_OUTPUT, 10, 21'000);
+
+    const latency_histogram h = t.histogram();
+    REQUIRE( h.count == 2 );
+    REQUIRE( h.max_ns == 10'000 );
+    REQUIRE( h.total_ns == 18'000 );
+
+    // capacity is 4: the first event was overwritten
+    REQUIRE( t.dropped_events() == 1 );
+    const std::vector<latency_tracer::event> e = t.events();
+    REQUIRE( e.size() == 4 );
+    REQUIRE( e.front().ts_ns == 10'000 );
+    REQUIRE( e[2].input_ts_ns == 10'000 );
+    REQUIRE( e[3].input_ts_ns == -1 );
+
+    std::FILE* f = std::tmpfile();
+    t.write_chrome_trace(f);
+    std::rewind(f);
+    std::string json;
+    for (int c; (c = std::fgetc(f)) != EOF;) json.push_back(static_cast<char>(c));
+    std::fclose(f);
+    REQUIRE( json.starts_with("{\"traceEvents\":[") );
+    REQUIRE( json.find("\"name\":\"latency\",\"ph\":\"X\",\"ts\":0.000,\"dur\":10.000") != std::string::npos );
+    REQUIRE( json.find("\"name\":\"latency\",\"ph\":\"X\",\"ts\":2.000,\"dur\":8.000") != std::string::npos );
+
+    t.clear();
+    REQUIRE( t.events().empty() );
+    REQUIRE( t.histogram().count == 0 );
+}
+
+TEST_CASE("trace: gather write is single output", "[trace]") {
+    latency_tracer t;
+    const std::string_view parts[] = { "frame ", "border", "" };
+    t.on_io(IO_INPUT, "q");
+    t.on_io_parts(IO_OUTPUT, parts);
+    const std::vector<latency_tracer::event> e = t.events();
+    REQUIRE( e.size() == 2 );
+    REQUIRE( e[1].bytes == 12 );
+    REQUIRE( e[1].input_ts_ns == e[0].ts_ns );
+    REQUIRE( t.histogram().count == 1 );
+}
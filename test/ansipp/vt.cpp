@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <ansipp/charbuf.hpp>
+#include <ansipp/attrs.hpp>
+#include <ansipp/cursor.hpp>
+#include <ansipp/terminal.hpp>
+
+#include "vt.hpp"
+
+using namespace ansipp;
+
+TEST_CASE("vt: text and cursor", "[vt]") {
+    vt_screen vt(10, 3);
+    charbuf cb;
+    vt.write((cb << "hello" << move_abs(3, 2) << "ab" << move(CURSOR_UP) << '!').view());
+    REQUIRE( vt.text() == "hell!\n  ab" );
+    REQUIRE( vt.cursor() == vec(5, 0) );
+
+    vt.write((cb.reset() << move_abs(1, 3) << "line\nnext").view());
+    REQUIRE( vt.text() == "  ab\nline\nnext" ); // scrolled
+    REQUIRE( vt.cursor() == vec(4, 2) );
+}
+
+TEST_CASE("vt: autowrap", "[vt]") {
+    vt_screen vt(4, 2);
+    vt.write("abcdef");
+    REQUIRE( vt.text() == "abcd\nef" );
+
+    charbuf cb;
+    vt.write((cb << line_wrap.off() << move_abs(1, 1) << "123456").view());
+    REQUIRE( vt.text() == "1236\nef" );
+}
+
+TEST_CASE("vt: erase", "[vt]") {
+    vt_screen vt(5, 2);
+    charbuf cb;
+    vt.write("abcdefghij");
+    vt.write((cb << move_abs(3, 1) << erase(LINE, TO_END)).view());
+    REQUIRE( vt.text() == "ab\nfghij" );
+    vt.write((cb.reset() << move_abs(2, 2) << erase(LINE, TO_BEGIN)).view());
+    REQUIRE( vt.text() == "ab\n  hij" );
+    vt.write((cb.reset() << erase(SCREEN, ALL)).view());
+    REQUIRE( vt.text() == "" );
+}
+
+TEST_CASE("vt: sgr", "[vt]") {
+    vt_screen vt(10, 1);
+    charbuf cb;
+    vt.write((cb << attrs().on(BOLD).fg(RED) << 'a' << attrs().off(BOLD).bg(rgb(1, 2, 3)) << 'b' << attrs() << 'c').view());
+    REQUIRE( vt.at(0, 0).pen.bold );
+    REQUIRE( vt.at(0, 0).pen.fg == vt_color::indexed(RED) );
+    REQUIRE( !vt.at(1, 0).pen.bold );
+    REQUIRE( vt.at(1, 0).pen.fg == vt_color::indexed(RED) );
+    REQUIRE( vt.at(1, 0).pen.bg == vt_color::rgb(1, 2, 3) );
+    REQUIRE( vt.at(2, 0).pen == vt_pen {} );
+    vt.write((cb.reset() << attrs().fg(static_cast<unsigned char>(200)).fg(YELLOW, true)).view());
+    REQUIRE( vt.current_pen().fg == vt_color::indexed(YELLOW + 8) );
+}
+
+TEST_CASE("vt: modes and alternate buffer", "[vt]") {
+    vt_screen vt(6, 2);
+    charbuf cb;
+    vt.write("main");
+    vt.write((cb << alternate_buffer.on() << cursor_visibility.off() << move_abs(1, 1) << "alt").view());
+    REQUIRE( vt.mode(1049) );
+    REQUIRE( !vt.mode(25) );
+    REQUIRE( vt.text() == "alt" );
+    vt.write((cb.reset() << alternate_buffer.off()).view());
+    REQUIRE( vt.text() == "main" );
+    REQUIRE( vt.cursor() == vec(4, 0) );
+}
+
+TEST_CASE("vt: redundant bytes", "[vt]") {
+    vt_screen vt(20, 2);
+    charbuf cb;
+    cb << move_abs(1, 1) << attrs().fg(GREEN) << "frame" << attrs();
+    const std::string frame = cb.str();
+
+    vt.write(frame);
+    REQUIRE( vt.bytes() == frame.size() );
+    REQUIRE( vt.redundant_bytes() == 3 ); // cursor is already at home position
+
+    // same frame again: only cursor movement and pen changes have effect
+    vt.reset_accounting();
+    vt.write(frame);
+    REQUIRE( vt.bytes() == frame.size() );
+    REQUIRE( vt.redundant_bytes() == 5 );
+
+    vt.reset_accounting();
+    vt.write((cb.reset() << attrs() << cursor_visibility.on() << move(CURSOR_UP, 0) << move_abs(6, 1)).view());
+    REQUIRE( vt.redundant_bytes() == vt.bytes() );
+}
@@ -0,0 +1,425 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ansipp/vec.hpp>
+
+/**
+ * @brief color of virtual terminal cell
+ */
+struct vt_color {
+    enum kind_type: std::uint8_t { DEFAULT, INDEXED, RGB };
+    kind_type kind = DEFAULT;
+    std::uint32_t value = 0; // palette index or 0xRRGGBB
+
+    static vt_color indexed(std::uint32_t index) { return vt_color { INDEXED, index }; }
+    static vt_color rgb(std::uint32_t r, std::uint32_t g, std::uint32_t b) { return vt_color { RGB, (r << 16) | (g << 8) | b }; }
+    bool operator==(const vt_color&) const = default;
+};
+
+/**
+ * @brief graphic rendition (SGR) state
+ */
+struct vt_pen {
+    bool bold = false;
+    bool dim = false;
+    bool italic = false;
+    bool underline = false;
+    bool blink = false;
+    bool inverse = false;
+    bool hidden = false;
+    bool strikethrough = false;
+    vt_color fg;
+    vt_color bg;
+    bool operator==(const vt_pen&) const = default;
+};
+
+struct vt_cell {
+    char32_t ch = U' ';
+    vt_pen pen;
+    bool operator==(const vt_cell&) const = default;
+};
+
+/**
+ * @brief minimal in-process VT (xterm subset) screen model for output verification.
+ *
+ * Supports printable UTF-8, CR, LF (as CR+LF like `ONLCR` by default), BS, TAB,
+ * `ESC 7`/`ESC 8`, `ESC c`, CSI cursor movement (`A`-`G`, `H`, `f`), erase (`J`, `K`, `X`), scroll (`S`, `T`), repeat (`b`),
+ * SGR (`m`, including 8-bit and RGB colors), DECSET/DECRST (`?h`, `?l`, alternate buffer `1049` and autowrap `7`).
+ * Other sequences are parsed and ignored.
+ *
+ * Byte accounting: every byte is attributed to an item (printable char, control char or escape sequence).
+ * Item is redundant if it didn't change any cell or terminal state (cursor position, pen, modes, saved cursor),
+ * i.e. char which rewrites the same cell content, SGR which sets current pen, move to current position.
+ */
+class vt_screen {
+public:
+    const int cols;
+    const int rows;
+    bool onlcr = true;
+
+private:
+    enum parse_state { GROUND, ESCAPE, CSI, IGNORE_STRING };
+
+    std::vector<vt_cell> grid;
+    std::vector<vt_cell> saved_grid; // main screen while alternate buffer is active
+    ansipp::vec cur;
+    ansipp::vec saved_cur;
+    vt_pen pen;
+    vt_pen saved_pen;
+    bool wrap_pending = false;
+    char32_t last_printed = 0; // for REP, cleared by any other item
+    std::map<unsigned int, bool> mode_values;
+
+    parse_state state = GROUND;
+    std::string seq;
+    char32_t utf8_cp = 0;
+    int utf8_left = 0;
+
+    std::uint64_t item_bytes = 0;
+    bool item_changed = false;
+    std::uint64_t total = 0;
+    std::uint64_t redundant = 0;
+
+    void end_item() {
+        total += item_bytes;
+        if (!item_changed) redundant += item_bytes;
+        item_bytes = 0;
+        item_changed = false;
+    }
+
+    vt_cell& cell(int x, int y) { return grid[static_cast<std::size_t>(y * cols + x)]; }
+    vt_cell blank() const { vt_cell c; c.pen.bg = pen.bg; return c; }
+
+    void set_cell(int x, int y, const vt_cell& v) {
+        vt_cell& c = cell(x, y);
+        if (c == v) return;
+        c = v;
+        item_changed = true;
+    }
+
+    void set_cursor(int x, int y) {
+        const ansipp::vec n(std::clamp(x, 0, cols - 1), std::clamp(y, 0, rows - 1));
+        if (n == cur && !wrap_pending) return;
+        cur = n;
+        wrap_pending = false;
+        item_changed = true;
+    }
+
+    void erase_cells(int from, int to) { // [from, to) linear indices
+        const vt_cell b = blank();
+        for (int i = from; i < to; ++i) set_cell(i % cols, i / cols, b);
+    }
+
+    void scroll_up(int n) {
+        for (int i = 0; i < n; ++i) {
+            const vt_cell b = blank();
+            for (int y = 0; y + 1 < rows; ++y) for (int x = 0; x < cols; ++x) set_cell(x, y, cell(x, y + 1));
+            for (int x = 0; x < cols; ++x) set_cell(x, rows - 1, b);
+        }
+    }
+
+    void scroll_down(int n) {
+        for (int i = 0; i < n; ++i) {
+            const vt_cell b = blank();
+            for (int y = rows - 1; y > 0; --y) for (int x = 0; x < cols; ++x) set_cell(x, y, cell(x, y - 1));
+            for (int x = 0; x < cols; ++x) set_cell(x, 0, b);
+        }
+    }
+
+    void line_feed() {
+        if (cur.y + 1 < rows) set_cursor(cur.x, cur.y + 1); else scroll_up(1);
+    }
+
+    // cursor advance isn't counted as change: rewriting the same cell content is redundant
+    void print(char32_t ch) {
+        if (wrap_pending) {
+            wrap_pending = false;
+            cur.x = 0;
+            if (cur.y + 1 < rows) ++cur.y; else scroll_up(1);
+        }
+        set_cell(cur.x, cur.y, vt_cell { ch, pen });
+        last_printed = ch;
+        if (cur.x + 1 < cols) ++cur.x; else if (mode(7)) wrap_pending = true;
+    }
+
+    void control(char ch) {
+        last_printed = 0;
+        switch (ch) {
+        case '\r': set_cursor(0, cur.y); break;
+        case '\n': if (onlcr) set_cursor(0, cur.y); line_feed(); break;
+        case '\b': set_cursor(cur.x - 1, cur.y); break;
+        case '\t': set_cursor((cur.x / 8 + 1) * 8, cur.y); break;
+        default: break;
+        }
+    }
+
+    void set_mode(unsigned int code, bool value) {
+        if (mode(code) == value) return;
+        mode_values[code] = value;
+        item_changed = true;
+        if (code == 1049) {
+            if (value) {
+                saved_cur = cur;
+                saved_grid = grid;
+                std::fill(grid.begin(), grid.end(), vt_cell {});
+            } else {
+                grid = saved_grid;
+                cur = saved_cur;
+            }
+            wrap_pending = false;
+        }
+    }
+
+    static std::vector<int> params(std::string_view p) {
+        std::vector<int> result(1, -1);
+        for (char c: p) {
+            if (c == ';') result.push_back(-1);
+            else if (c >= '0' && c <= '9') result.back() = (result.back() < 0 ? 0 : result.back() * 10) + (c - '0');
+        }
+        return result;
+    }
+
+    static int param(const std::vector<int>& p, std::size_t i, int def) {
+        return i < p.size() && p[i] > 0 ? p[i] : def;
+    }
+
+    void sgr(const std::vector<int>& p) {
+        const vt_pen before = pen;
+        for (std::size_t i = 0; i < p.size(); ++i) {
+            const int v = p[i] < 0 ? 0 : p[i];
+            switch (v) {
+            case 0: pen = vt_pen {}; break;
+            case 1: pen.bold = true; break;
+            case 2: pen.dim = true; break;
+            case 3: pen.italic = true; break;
+            case 4: pen.underline = true; break;
+            case 5: case 6: pen.blink = true; break;
+            case 7: pen.inverse = true; break;
+            case 8: pen.hidden = true; break;
+            case 9: pen.strikethrough = true; break;
+            case 22: pen.bold = pen.dim = false; break;
+            case 23: pen.italic = false; break;
+            case 24: pen.underline = false; break;
+            case 25: pen.blink = false; break;
+            case 27: pen.inverse = false; break;
+            case 28: pen.hidden = false; break;
+            case 29: pen.strikethrough = false; break;
+            case 38: case 48: {
+                vt_color& c = v == 38 ? pen.fg : pen.bg;
+                if (i + 2 < p.size() && p[i + 1] == 5) {
+                    c = vt_color::indexed(static_cast<std::uint32_t>(p[i + 2]));
+                    i += 2;
+                } else if (i + 4 < p.size() && p[i + 1] == 2) {
+                    c = vt_color::rgb(static_cast<std::uint32_t>(p[i + 2]), static_cast<std::uint32_t>(p[i + 3]), static_cast<std::uint32_t>(p[i + 4]));
+                    i += 4;
+                }
+                break;
+            }
+            case 39: pen.fg = vt_color {}; break;
+            case 49: pen.bg = vt_color {}; break;
+            default:
+                if (v >= 30 && v <= 37) pen.fg = vt_color::indexed(static_cast<std::uint32_t>(v - 30));
+                else if (v >= 40 && v <= 47) pen.bg = vt_color::indexed(static_cast<std::uint32_t>(v - 40));
+                else if (v >= 90 && v <= 97) pen.fg = vt_color::indexed(static_cast<std::uint32_t>(v - 90 + 8));
+                else if (v >= 100 && v <= 107) pen.bg = vt_color::indexed(static_cast<std::uint32_t>(v - 100 + 8));
+                break;
+            }
+        }
+        if (pen != before) item_changed = true;
+    }
+
+    void csi_dispatch(char final) {
+        const char32_t last = last_printed;
+        last_printed = 0;
+        const bool priv = !seq.empty() && seq[0] == '?';
+        const std::vector<int> p = params(priv ? std::string_view(seq).substr(1) : std::string_view(seq));
+        if (priv) {
+            if (final == 'h' || final == 'l') {
+                for (int code: p) if (code >= 0) set_mode(static_cast<unsigned int>(code), final == 'h');
+            }
+            return;
+        }
+        const int n = param(p, 0, 1);
+        switch (final) {
+        case 'A': set_cursor(cur.x, cur.y - n); break;
+        case 'B': set_cursor(cur.x, cur.y + n); break;
+        case 'C': set_cursor(cur.x + n, cur.y); break;
+        case 'D': set_cursor(cur.x - n, cur.y); break;
+        case 'E': set_cursor(0, cur.y + n); break;
+        case 'F': set_cursor(0, cur.y - n); break;
+        case 'G': set_cursor(n - 1, cur.y); break;
+        case 'H': case 'f': set_cursor(param(p, 1, 1) - 1, n - 1); break;
+        case 'J': {
+            const int at = cur.y * cols + cur.x;
+            switch (param(p, 0, 0)) {
+            case 0: erase_cells(at, cols * rows); break;
+            case 1: erase_cells(0, at + 1); break;
+            default: erase_cells(0, cols * rows); break;
+            }
+            break;
+        }
+        case 'K': {
+            const int line = cur.y * cols;
+            switch (param(p, 0, 0)) {
+            case 0: erase_cells(line + cur.x, line + cols); break;
+            case 1: erase_cells(line, line + cur.x + 1); break;
+            default: erase_cells(line, line + cols); break;
+            }
+            break;
+        }
+        case 'X': {
+            const int line = cur.y * cols;
+            erase_cells(line + cur.x, line + std::min(cur.x + n, cols));
+            break;
+        }
+        case 'b':
+            if (last == 0) break;
+            for (int i = 0; i < n; ++i) print(last);
+            break;
+        case 'S': scroll_up(n); break;
+        case 'T': scroll_down(n); break;
+        case 'm': sgr(p); break;
+        default: break;
+        }
+    }
+
+    void esc_dispatch(char ch) {
+        last_printed = 0;
+        switch (ch) {
+        case '7':
+            if (saved_cur == cur && saved_pen == pen) break;
+            saved_cur = cur;
+            saved_pen = pen;
+            item_changed = true;
+            break;
+        case '8':
+            set_cursor(saved_cur.x, saved_cur.y);
+            if (pen != saved_pen) { pen = saved_pen; item_changed = true; }
+            break;
+        case 'c': reset(); item_changed = true; break;
+        default: break;
+        }
+    }
+
+    void feed(char c) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        ++item_bytes;
+        switch (state) {
+        case GROUND:
+            if (utf8_left > 0) {
+                utf8_cp = (utf8_cp << 6) | (u & 0x3f);
+                if (--utf8_left == 0) { print(utf8_cp); end_item(); }
+            } else if (u == 0x1b) {
+                state = ESCAPE;
+            } else if (u < 0x20 || u == 0x7f) {
+                control(c);
+                end_item();
+            } else if (u < 0x80) {
+                print(u);
+                end_item();
+            } else if ((u & 0xe0) == 0xc0) {
+                utf8_cp = u & 0x1f; utf8_left = 1;
+            } else if ((u & 0xf0) == 0xe0) {
+                utf8_cp = u & 0x0f; utf8_left = 2;
+            } else {
+                utf8_cp = u & 0x07; utf8_left = 3;
+            }
+            break;
+        case ESCAPE:
+            if (c == '[') { state = CSI; seq.clear(); }
+            else if (c == ']' || c == 'P' || c == '_' || c == '^') { state = IGNORE_STRING; }
+            else { esc_dispatch(c); state = GROUND; end_item(); }
+            break;
+        case CSI:
+            if (u >= 0x40 && u <= 0x7e) { csi_dispatch(c); state = GROUND; end_item(); }
+            else seq.push_back(c);
+            break;
+        case IGNORE_STRING: // OSC, DCS, etc: until BEL or ST
+            if (u == 0x07 || (c == '\\' && !seq.empty() && seq.back() == '\x1b')) { state = GROUND; seq.clear(); end_item(); }
+            else seq.assign(1, c);
+            break;
+        }
+    }
+
+public:
+    vt_screen(int cols, int rows): cols(cols), rows(rows) { reset(); }
+
+    /**
+     * @brief hard reset (`ESC c`), accounting is not reset
+     */
+    void reset() {
+        grid.assign(static_cast<std::size_t>(cols * rows), vt_cell {});
+        saved_grid.clear();
+        cur = saved_cur = ansipp::vec();
+        pen = saved_pen = vt_pen {};
+        wrap_pending = false;
+        last_printed = 0;
+        mode_values.clear();
+        mode_values[7] = true;
+        mode_values[25] = true;
+    }
+
+    /**
+     * @brief applies terminal output, sequences may be split between calls
+     */
+    vt_screen& write(std::string_view data) {
+        for (char c: data) feed(c);
+        return *this;
+    }
+
+    const vt_cell& at(int x, int y) const { return grid[static_cast<std::size_t>(y * cols + x)]; }
+    ansipp::vec cursor() const { return cur; }
+    const vt_pen& current_pen() const { return pen; }
+
+    bool mode(unsigned int code) const {
+        auto it = mode_values.find(code);
+        return it != mode_values.end() && it->second;
+    }
+
+    /**
+     * @brief row text as UTF-8, trailing spaces are removed
+     */
+    std::string row(int y) const {
+        std::string result;
+        for (int x = 0; x < cols; ++x) {
+            const char32_t ch = at(x, y).ch;
+            if (ch < 0x80) {
+                result.push_back(static_cast<char>(ch));
+            } else if (ch < 0x800) {
+                result.push_back(static_cast<char>(0xc0 | (ch >> 6)));
+                result.push_back(static_cast<char>(0x80 | (ch & 0x3f)));
+            } else if (ch < 0x10000) {
+                result.push_back(static_cast<char>(0xe0 | (ch >> 12)));
+                result.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3f)));
+                result.push_back(static_cast<char>(0x80 | (ch & 0x3f)));
+            } else {
+                result.push_back(static_cast<char>(0xf0 | (ch >> 18)));
+                result.push_back(static_cast<char>(0x80 | ((ch >> 12) & 0x3f)));
+                result.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3f)));
+                result.push_back(static_cast<char>(0x80 | (ch & 0x3f)));
+            }
+        }
+        result.erase(result.find_last_not_of(' ') + 1);
+        return result;
+    }
+
+    /**
+     * @brief all rows separated by `\n` (trailing spaces and empty trailing rows are removed)
+     */
+    std::string text() const {
+        std::string result;
+        for (int y = 0; y < rows; ++y) (result += row(y)) += '\n';
+        result.erase(result.find_last_not_of('\n') + 1);
+        return result;
+    }
+
+    std::uint64_t bytes() const { return total; }
+    std::uint64_t redundant_bytes() const { return redundant; }
+    void reset_accounting() { total = redundant = 0; }
+};